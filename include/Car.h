@@ -1,14 +1,32 @@
 #pragma once
 #include "DataStructures.h"
+#include "RandomBlock.h"
+#include <cstdint>
 #include <vector>
 
-#include <random>
+// Stan bolidu widziany przez innych w danym kroku (migawka z poprzedniego kroku)
+struct CarSnapshot {
+    double totalDistance;
+    double currentSpeed;
+    int pace;
+    int racecraft;
+    bool finished;
+};
 
 class Car {
 public:
     Car(const Driver& driver, const Team& team, int startGridPosition);
 
-    void update(double dt, const Track& track, int totalLaps, WeatherType weather, std::mt19937& rng, const Car* carAhead = nullptr);
+    void placeOnGrid(int startGridPosition);
+    void reserveHistory(int totalLaps);
+
+    // Klucz strumienia losowego bolidu - zależy tylko od ziarna wyścigu i kierowcy
+    uint64_t randomKey(unsigned int raceSeed) const;
+    void setRandomStream(int index) { stream = index; }
+
+    void update(double dt, const Track& track, int totalLaps, WeatherType weather, const RandomBlock& random,
+                const CarSnapshot* carAhead = nullptr);
+    CarSnapshot snapshot() const;
 
     double getTotalDistance() const { return totalDistance; }
     double getLapDistance() const { return lapDistance; }
@@ -27,9 +45,15 @@ public:
     }
     double getFinishTime() const { return finishTime; }
 
+    int getGridPosition() const { return gridPosition; }
+    const std::vector<double>& getLapTimes() const { return lapTimes; }
+    const std::vector<int>& getPitLaps() const { return pitLaps; }
+
 private:
     Driver driver;
     Team team;
+    int gridPosition = 0;
+    int stream = 0;         // indeks w RandomBlock wyścigu
 
     double totalDistance = 0.0;
     double lapDistance = 0.0;
@@ -45,6 +69,10 @@ private:
 
     double pitStopTimer = 0.0;
 
+    double lapTimer = 0.0;
+    std::vector<double> lapTimes;
+    std::vector<int> pitLaps;
+
     double calculateTargetSpeed(const TrackSegment& segment, double gripModifier);
     double getEffectiveAcceleration(double gripModifier);
     double getEffectiveBraking(double gripModifier);
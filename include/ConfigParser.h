@@ -15,6 +15,9 @@ public:
     };
 
     ConfigParser();
+    static std::string locateConfigDir();
+    static WeatherType parseWeather(const std::string& name);
+    static std::string weatherName(WeatherType weather);
     bool loadMainConfig(const std::string& filepath);
     Track loadTrack(const std::string& filepath);
 
@@ -40,3 +40,19 @@ struct Track {
     std::vector<TrackSegment> segments;
     double totalLength;
 };
+
+struct CarResult {
+    std::string driverName;
+    std::string teamName;
+    int gridPosition;
+    int finishPosition;
+    double finishTime;
+    std::vector<double> lapTimes;
+    std::vector<int> pitLaps;
+};
+
+struct RaceResult {
+    unsigned int seed;
+    std::vector<CarResult> classification;
+};
+
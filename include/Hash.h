@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// FNV-1a 64-bit - sumy kontrolne i klucze danych symulacji
+constexpr uint64_t FNV_OFFSET_BASIS = 1469598103934665603ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a(std::string_view text, uint64_t hash = FNV_OFFSET_BASIS) {
+    return fnv1a(text.data(), text.size(), hash);
+}
+
+// Mieszanie splitmix64 - rozprasza bity ziaren
+inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
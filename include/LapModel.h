@@ -0,0 +1,71 @@
+#pragma once
+#include "Simulation.h"
+#include <string>
+#include <vector>
+
+struct DriverLapModel {
+    std::string driverName;
+    std::string teamName;
+    double baseLapTime;      // czas okrążenia na nowych oponach
+    double tireDegradation;  // strata czasu na każde okrążenie wieku opon
+    double lapTimeSigma;
+    double firstLapDelta;    // strata startowa niezależna od pola startowego
+    double pitLoss;
+    double stintLength;      // średnia długość przejazdu, 0 = brak zjazdów
+    double stintSigma;
+    int minLapsRemaining;
+};
+
+struct LapModelAccuracy {
+    struct DriverRow {
+        std::string driverName;
+        double fullMeanPosition;
+        double modelMeanPosition;
+        double fullMeanTime;
+        double modelMeanTime;
+    };
+
+    std::vector<DriverRow> drivers;
+    double meanAbsPositionError;
+    double meanRelTimeError;
+    double rankCorrelation;
+    double fullSeconds;
+    double modelSeconds;
+};
+
+// Uproszczony model wyścigu liczony okrążeniami, kalibrowany z pełnej fizyki
+class LapModel {
+public:
+    static LapModel calibrate(const RaceSetup& setup, int races, unsigned int firstSeed);
+    static LapModelAccuracy evaluate(const LapModel& model, const RaceSetup& setup, int races, unsigned int firstSeed);
+
+    bool save(const std::string& filepath) const;
+    bool load(const std::string& filepath);
+
+    // Model pasuje do wyścigu, gdy zgadzają się tor, pogoda i liczba okrążeń; kierowcy
+    // bez modelu dla pary kierowca + zespół dostają model średni (z ostrzeżeniem)
+    bool compatible(const RaceSetup& setup) const;
+
+    // Dla niepasującego wyścigu (compatible() == false) zwraca pustą klasyfikację
+    RaceResult simulate(const RaceSetup& setup, unsigned int seed) const;
+
+    const std::string& getTrackName() const { return trackName; }
+    WeatherType getWeather() const { return weather; }
+    int getLaps() const { return laps; }
+    const std::vector<DriverLapModel>& getDrivers() const { return drivers; }
+
+private:
+    std::string trackName;
+    WeatherType weather = WeatherType::Sunny;
+    int laps = 0;
+    int calibrationRaces = 0;
+    double gridSlotTime = 0.0;
+    double trafficWindow = 1.0;
+    double minGap = 0.3;
+    std::vector<DriverLapModel> drivers;
+    DriverLapModel fallback;
+
+    const DriverLapModel* findExact(const std::string& driverName, const std::string& teamName) const;
+    const DriverLapModel& find(const std::string& driverName, const std::string& teamName) const;
+    bool matchesRace(const RaceSetup& setup) const;
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include "Simulation.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+class LapModel;
+class ResultCache;
+
+enum class SimFidelity {
+    Full,
+    LapModel
+};
+
+enum class MonteCarloMetric {
+    WinProbability,
+    PodiumProbability,
+    MeanPosition
+};
+
+struct MetricTarget {
+    MonteCarloMetric metric;
+    double halfWidth;   // docelowa połowa szerokości przedziału ufności
+};
+
+struct MonteCarloOptions {
+    std::vector<MetricTarget> targets;  // pusta lista = wszystkie metryki z domyślną precyzją
+    double confidence = 0.95;
+    int batchSize = 200;
+    int threads = 0;                // 0 = liczba rdzeni
+    int minRaces = 200;
+    int maxRaces = 1000000;
+    double timeBudgetSeconds = 0.0; // 0 = bez limitu czasu
+    unsigned int firstSeed = 1;
+    SimFidelity fidelity = SimFidelity::Full;
+    const LapModel* lapModel = nullptr;
+    ResultCache* cache = nullptr;   // tylko pełna symulacja; model okrążeniowy jest tańszy od odczytu
+};
+
+struct Estimate {
+    double value;
+    double halfWidth;
+};
+
+struct DriverEstimates {
+    std::string driverName;
+    Estimate win;
+    Estimate podium;
+    Estimate meanPosition;
+};
+
+// Średnia i wariancja liczone przyrostowo (Welford)
+struct RunningStat {
+    double n = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double x);
+    double variance() const { return (n > 1) ? m2 / (n - 1) : 0.0; }
+};
+
+// Kwantyl rozkładu normalnego dla dwustronnego przedziału ufności
+double twoSidedZ(double confidence);
+
+// Zadania [0, count) rozdzielane dynamicznie na `threads` wątków (wątek wywołujący
+// też liczy); zadanie pisze tylko własną część wyniku
+void parallelFor(int count, int threads, const std::function<void(int)>& job);
+
+struct SamplingLimits {
+    int batchSize;
+    int minRaces;
+    int maxRaces;
+    double timeBudgetSeconds;   // 0 = bez limitu czasu
+    unsigned int firstSeed;
+};
+
+// Paczki kolejnych ziaren: runBatch(pierwsze ziarno, liczba) liczy i scala paczkę
+// w kolejności ziaren, po minRaces pętla kończy się, gdy converged(wyścigi, sekundy)
+// zwróci true, albo po limicie czasu; zwraca liczbę wyścigów
+int sampleBatches(const SamplingLimits& limits, const std::function<void(unsigned int, int)>& runBatch,
+                  const std::function<bool(int, double)>& converged, double& seconds);
+
+struct MonteCarloReport {
+    std::vector<DriverEstimates> drivers;
+    int races;
+    double seconds;
+    bool converged;
+    double worstRatio;  // największy stosunek szerokości przedziału do celu
+};
+
+// Próbkowanie Monte Carlo w równoległych paczkach wyścigów; kończy się, gdy
+// wszystkie żądane metryki osiągną docelową precyzję lub skończy się czas
+class AdaptiveSampler {
+public:
+    AdaptiveSampler(const RaceSetup& setup, const MonteCarloOptions& options);
+
+    MonteCarloReport run();
+
+private:
+    RaceSetup setup;
+    MonteCarloOptions options;
+    double z;
+
+    std::vector<RunningStat> wins;
+    std::vector<RunningStat> podiums;
+    std::vector<RunningStat> positions;
+
+    void runBatch(unsigned int firstSeed, int count, std::vector<int>& finishPositions) const;
+    Estimate proportion(const RunningStat& s) const;
+    Estimate mean(const RunningStat& s) const;
+    MonteCarloReport buildReport(int races, double seconds) const;
+};
@@ -1,22 +1,63 @@
 #pragma once
 #include "Car.h"
+#include "RaceTask.h"
+#include <memory>
 #include <vector>
-#include <random>
 
 class Race {
 public:
-    Race(const std::vector<Car>& cars, const Track& track, int totalLaps);
-    
+    Race(const std::vector<Car>& cars, const Track& track, int totalLaps, WeatherType weather = WeatherType::Sunny);
+    Race(const std::vector<Car>& cars, const Track& track, int totalLaps, WeatherType weather, unsigned int seed);
+    ~Race();
+    // Wątki puli odwołują się do obiektu - bez kopiowania i przenoszenia
+    Race(const Race&) = delete;
+    Race& operator=(const Race&) = delete;
+
     void run();
+    RaceResult simulate();
+
+    // Wyścig jako korutyna: jedna klatka (stepsPerFrame kroków) na wznowienie
+    RaceTask live(int stepsPerFrame = 100);
+    bool isFinished() const { return raceFinished; }
+    double getRaceTime() const { return raceTime; }
+    RaceResult getResult() const;
+
+    // Ponowne użycie obiektu wyścigu bez nowych alokacji (tryb wsadowy)
+    void reset(const std::vector<Car>& grid, unsigned int seed);
+    void runToFinish();
+    const std::vector<Car>& getCars() const { return cars; }
+
+    // Liczba wątków aktualizujących bolidy w obrębie jednego kroku; pula wątków
+    // powstaje tutaj (lub w reset przy innej liczbie bolidów) i służy kolejnym klatkom i wyścigom
+    void setThreadCount(int threads);
 
 private:
     std::vector<Car> cars;
     Track track;
     int totalLaps;
+    WeatherType weather;
+    unsigned int seed;
+    double dt = 0.5;
     double raceTime = 0.0;
     bool raceFinished = false;
-    std::mt19937 rng;
+    int threadCount = 1;
+    std::vector<CarSnapshot> snapshots;
+    RandomBlock random;
+    std::vector<uint64_t> streamKeys;
+    uint64_t step = 0;
+
+    struct StepPool;
+    std::unique_ptr<StepPool> pool;
 
+    void seedCars();
+    void resizePool();
+    void stopPool();
+    void poolWorker(int worker);
+    bool stepPartition(int worker, int workers);
+    void completeStep();
+    void takeSnapshots();
+    bool advance(int steps);
+    bool stepCar(size_t i);
     void updateLeaderboard();
     void printStatus();
 };
@@ -0,0 +1,66 @@
+#pragma once
+#include "Race.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Przeplata wiele wyścigów-korutyn na kilku wątkach roboczych. Każdy wyścig
+// ma własne tempo: `speed` sekund symulacji na sekundę rzeczywistą
+// (speed <= 0 - tak szybko, jak pozwalają wątki).
+class RaceScheduler {
+public:
+    // Wywoływane po każdej klatce. Przy ostatniej race.isFinished() - to jedyne
+    // miejsce na odczyt wyniku (getResult), bo zaraz potem wyścig jest zwalniany
+    using FrameCallback = std::function<void(int raceId, const Race& race)>;
+
+    explicit RaceScheduler(int workers, int stepsPerFrame = 100);
+    ~RaceScheduler();
+    RaceScheduler(const RaceScheduler&) = delete;
+    RaceScheduler& operator=(const RaceScheduler&) = delete;
+
+    int add(std::unique_ptr<Race> race, double speed = 0.0, FrameCallback onFrame = {});
+    // Bez skutku dla zakończonych wyścigów
+    void setSpeed(int raceId, double speed);
+
+    void waitAll();
+    void stop();
+
+    size_t runningCount() const;
+    size_t finishedCount() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        int id;
+        std::unique_ptr<Race> race;
+        RaceTask task;
+        double speed;
+        FrameCallback onFrame;
+        Clock::time_point due;
+    };
+
+    struct LaterFirst {
+        bool operator()(const Entry* a, const Entry* b) const { return a->due > b->due; }
+    };
+
+    int stepsPerFrame;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::priority_queue<Entry*, std::vector<Entry*>, LaterFirst> ready;
+    std::unordered_map<int, std::unique_ptr<Entry>> entries;   // tylko trwające wyścigi
+    int nextId = 0;
+    size_t running = 0;
+    size_t finished = 0;
+    bool stopping = false;
+    std::vector<std::jthread> workers;
+
+    void workerLoop();
+};
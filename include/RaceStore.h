@@ -0,0 +1,91 @@
+#pragma once
+#include "DataStructures.h"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Podsumowanie wyścigu w postaci kolumnowej; kierowcy jako indeksy słownika magazynu
+struct RaceSummary {
+    uint32_t seed = 0;
+    int winner = -1;
+    std::vector<int> grid;          // [kierowca] pole startowe, od 1
+    std::vector<int> order;         // [pozycja] indeks kierowcy
+    std::vector<double> finishTimes; // [pozycja] czas ukończenia [s], rozdzielczość 1 ms
+    std::vector<int> lapPositions;  // [okrążenie * kierowcy + kierowca] pozycja na koniec okrążenia
+    std::vector<std::vector<int>> pitLaps; // [kierowca]
+};
+
+enum RaceStoreColumn : unsigned {
+    COLUMN_SEED = 1u << 0,
+    COLUMN_WINNER = 1u << 1,
+    COLUMN_GRID = 1u << 2,
+    COLUMN_ORDER = 1u << 3,
+    COLUMN_FINISH_TIMES = 1u << 4,
+    COLUMN_LAP_POSITIONS = 1u << 5,
+    COLUMN_PIT_LAPS = 1u << 6,
+    COLUMN_ALL = (1u << 7) - 1
+};
+
+// Zapis: wyścigi buforowane w blokach, każda kolumna kodowana osobno
+// (delta + zigzag + varint, serie zer dla pozycji na okrążeniach)
+class RaceStoreWriter {
+public:
+    ~RaceStoreWriter();
+
+    bool open(const std::string& filepath, const std::vector<std::string>& drivers, int laps, int blockSize = 4096);
+    bool append(const RaceResult& result);
+    bool close();
+
+private:
+    std::ofstream file;
+    std::vector<std::string> drivers;
+    int laps = 0;
+    int blockSize = 4096;
+    int blockRaces = 0;
+
+    std::vector<std::vector<uint8_t>> columns;
+    std::vector<uint8_t> winnerSet;
+
+    // Stan poprzedniego wyścigu w bloku - bazą dla kodowania delta
+    int64_t prevSeed = 0;
+    int64_t prevWinnerTime = 0;
+    std::vector<int> prevGrid;
+    std::vector<int> prevOrder;
+
+    bool flushBlock();
+    void resetBlock();
+};
+
+class RaceStoreReader {
+public:
+    bool open(const std::string& filepath);
+
+    const std::vector<std::string>& getDrivers() const { return drivers; }
+    int getLaps() const { return laps; }
+    size_t raceCount() const { return totalRaces; }
+    int driverIndex(const std::string& name) const;
+
+    // Dekoduje tylko wskazane kolumny; bloki bez zwycięstwa kierowcy `winner` są pomijane
+    void scan(unsigned columnMask, const std::function<void(const RaceSummary&)>& visit, int winner = -1);
+
+    // Ziarna wyścigów wygranych przez kierowcę startującego z pola >= minGrid
+    std::vector<uint32_t> findWins(const std::string& driver, int minGrid = 1);
+
+private:
+    struct Block {
+        int races;
+        std::vector<uint64_t> columnOffsets;
+        std::vector<uint64_t> columnSizes;
+        std::vector<uint8_t> winnerSet;
+    };
+
+    std::ifstream file;
+    std::vector<std::string> drivers;
+    int laps = 0;
+    size_t totalRaces = 0;
+    std::vector<Block> blocks;
+
+    std::vector<uint8_t> readColumn(const Block& block, int column);
+};
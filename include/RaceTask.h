@@ -0,0 +1,57 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Korutyna wyścigu: wstrzymuje się na granicy każdej klatki i zwraca
+// czas symulacji, o który przesunęła się ta klatka
+class RaceTask {
+public:
+    struct promise_type {
+        double frameTime = 0.0;
+        std::exception_ptr exception;
+
+        RaceTask get_return_object() {
+            return RaceTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(double simulatedSeconds) noexcept {
+            frameTime = simulatedSeconds;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    RaceTask() = default;
+    RaceTask(RaceTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    RaceTask& operator=(RaceTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    RaceTask(const RaceTask&) = delete;
+    RaceTask& operator=(const RaceTask&) = delete;
+    ~RaceTask() {
+        if (handle) handle.destroy();
+    }
+
+    // Wykonuje jedną klatkę; false, gdy wyścig się zakończył
+    bool resume() {
+        if (!handle || handle.done()) return false;
+        handle.resume();
+        if (handle.promise().exception) std::rethrow_exception(handle.promise().exception);
+        return !handle.done();
+    }
+
+    bool done() const { return !handle || handle.done(); }
+    double frameTime() const { return handle ? handle.promise().frameTime : 0.0; }
+
+private:
+    explicit RaceTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Liczby losowe dla wszystkich bolidów wyścigu liczone blokami z generatora
+// licznikowego: każda wartość to skrót splitmix64 z klucza strumienia bolidu
+// (ziarno + kierowca) i numeru kroku, więc nie ma stanu do przenoszenia między
+// wywołaniami, pętla po bolidach nie ma rozgałęzień, a i-ty krok bolidu zawsze
+// dostaje te same liczby niezależnie od przebiegu wyścigu
+class RandomBlock {
+public:
+    static constexpr int UNIFORMS_PER_STEP = 2;    // [0] błąd kierowcy, [1] próba wyprzedzania
+
+    // Nowe strumienie; normalne dla końców okrążeń liczone raz na wyścig
+    void reset(const std::vector<uint64_t>& streamKeys, int laps);
+
+    // Jednostajne [0, 1) dla kroku `step` wszystkich strumieni
+    void fillStep(uint64_t step);
+
+    const double* stepUniforms(int stream) const { return &uniforms[stream * UNIFORMS_PER_STEP]; }
+    const double* lapNormals(int stream) const { return &normals[stream * laps]; }
+
+private:
+    std::vector<uint64_t> keys;
+    std::vector<double> uniforms;   // [strumień * UNIFORMS_PER_STEP + slot]
+    std::vector<double> normals;    // [strumień * okrążenia + okrążenie], N(0, 1)
+    int laps = 0;
+};
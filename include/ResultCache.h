@@ -0,0 +1,43 @@
+#pragma once
+#include "Simulation.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct CacheStats {
+    int hits = 0;
+    int misses = 0;
+    int evicted = 0;
+};
+
+// Dyskowa pamięć podręczna wyników pełnej symulacji adresowana treścią: klucz to
+// skrót wszystkich wejść scenariusza (zespoły, kierowcy, segmenty toru, okrążenia,
+// pogoda, wersja symulatora), a każde ziarno jest osobnym wpisem
+// <katalog>/<klucz>/<ziarno>.f1res. Po przekroczeniu limitu rozmiaru usuwane są
+// najdawniej używane wpisy (czas modyfikacji odświeżany przy trafieniu).
+class ResultCache {
+public:
+    explicit ResultCache(const std::string& directory, uint64_t maxBytes = 1ULL << 30);
+
+    bool open();
+
+    static std::string scenarioKey(const RaceSetup& setup);
+
+    bool load(const std::string& key, unsigned int seed, RaceResult& result);
+    bool store(const std::string& key, const RaceResult& result);
+
+    // Wyniki dla ziaren [firstSeed, firstSeed + count); liczone są tylko brakujące
+    std::vector<RaceResult> run(const RaceSetup& setup, unsigned int firstSeed, int count, int threads = 1);
+
+    uint64_t sizeBytes() const { return totalBytes; }
+    const CacheStats& getStats() const { return stats; }
+
+private:
+    std::string directory;
+    uint64_t maxBytes;
+    uint64_t totalBytes = 0;
+    CacheStats stats;
+
+    std::string entryPath(const std::string& key, unsigned int seed) const;
+    void evict();
+};
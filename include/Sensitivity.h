@@ -0,0 +1,86 @@
+#pragma once
+#include "MonteCarlo.h"
+#include "Simulation.h"
+#include <string>
+#include <vector>
+
+enum class SensitivityParameter {
+    TopSpeed,
+    Acceleration,
+    Braking,
+    BaseTireGrip,
+    DriverPace
+};
+
+struct Perturbation {
+    SensitivityParameter parameter;
+    std::string target;   // zespół, a dla DriverPace - kierowca
+    double step;          // krok różnicy centralnej w jednostkach parametru
+};
+
+struct SensitivityOptions {
+    std::vector<Perturbation> perturbations;
+    double confidence = 0.95;
+    double precision = 0.05;        // docelowa połowa szerokości przedziału zmiany pozycji na krok
+    int batchSize = 20;             // ziarna na paczkę
+    int threads = 0;                // 0 = liczba rdzeni
+    int minRaces = 40;
+    int maxRaces = 100000;
+    double timeBudgetSeconds = 0.0; // 0 = bez limitu czasu
+    unsigned int firstSeed = 1;
+};
+
+struct SensitivityEstimate {
+    Perturbation perturbation;
+    std::string driverName;
+    double baselinePosition;
+    Estimate slope;             // d(pozycja na mecie) / d(parametr)
+    double varianceReduction;   // ile razy mniej wyścigów niż przy niezależnych losowaniach (0 = brak danych)
+};
+
+struct SensitivityReport {
+    std::vector<SensitivityEstimate> estimates;
+    int races;          // ziarna
+    int simulations;    // wszystkie przeliczone wyścigi
+    double seconds;
+    bool converged;
+};
+
+bool parseSensitivityParameter(const std::string& name, SensitivityParameter& parameter);
+std::string sensitivityParameterName(SensitivityParameter parameter);
+
+// Zaburzenia wybranych parametrów dla wszystkich zespołów i kierowców (lub tylko
+// zespołu / kierowcy `target`); krok to ułamek bieżącej wartości, dla pace co najmniej 1
+std::vector<Perturbation> buildPerturbations(const RaceSetup& setup, const std::vector<SensitivityParameter>& parameters,
+                                             double relativeStep, const std::string& target = "");
+
+// Wrażliwość średniej pozycji na mecie metodą wspólnych liczb losowych: dla każdego
+// ziarna wyścig bazowy i pary +krok/-krok korzystają z tych samych strumieni losowych
+// (kwalifikacje z ziarna, strumienie bolidów z ziarna i nazwy kierowcy), więc różnica
+// pozycji ma znacznie mniejszą wariancję niż przy niezależnym próbkowaniu
+class SensitivityAnalyzer {
+public:
+    SensitivityAnalyzer(const RaceSetup& setup, const SensitivityOptions& options);
+
+    SensitivityReport run();
+
+private:
+    struct Series {
+        size_t perturbation;
+        size_t driver;
+        RunningStat slope;
+        RunningStat plus;
+        RunningStat minus;
+    };
+
+    RaceSetup setup;
+    SensitivityOptions options;
+    double z;
+
+    std::vector<RaceSetup> variants;    // [0] bazowy, [1 + 2p] +krok, [2 + 2p] -krok
+    std::vector<RunningStat> baseline;  // [kierowca]
+    std::vector<Series> series;
+
+    void runBatch(unsigned int firstSeed, int count, std::vector<int>& finishPositions) const;
+    SensitivityReport buildReport(int races, double seconds) const;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include "DataStructures.h"
+#include "Car.h"
+#include <random>
+#include <string>
+#include <vector>
+
+struct GridPosition {
+    int position;
+    Driver driver;
+    Team team;
+    double qualifyingTime;
+};
+
+struct RaceSetup {
+    std::vector<Driver> drivers;
+    std::vector<Team> teams;
+    Track track;
+    int laps;
+    WeatherType weather;
+    int stepThreads = 1;
+};
+
+constexpr double QUALIFYING_TIME_SIGMA = 0.2;
+
+// Wersja modelu fizycznego - zwiększana przy każdej zmianie, po której to samo
+// ziarno daje inny wynik (unieważnia pamięć podręczną wyników)
+constexpr int SIMULATOR_VERSION = 2;
+
+double qualifyingBaseLapTime(const Track& track);
+double qualifyingTimeMultiplier(const Driver& driver, const Team& team);
+std::vector<GridPosition> simulateQualifying(const std::vector<Driver>& drivers, const std::vector<Team>& teams, const Track& track, std::mt19937& gen);
+std::vector<Car> buildStartingGrid(const std::vector<GridPosition>& grid);
+
+// Pełna symulacja fizyczna: kwalifikacje i wyścig wyznaczone jednym ziarnem
+RaceResult simulateRace(const RaceSetup& setup, unsigned int seed);
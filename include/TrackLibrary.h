@@ -0,0 +1,53 @@
+#pragma once
+#include "DataStructures.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct TrackInfo {
+    std::string_view name;      // zakończona zerem w pliku; pusta dla uszkodzonego wpisu
+    double totalLength;
+    uint32_t segmentCount;
+    uint64_t checksum;
+};
+
+// Biblioteka torów w jednym pliku binarnym: indeks (nazwa, długość, liczba
+// segmentów, suma kontrolna) i spakowane segmenty. Plik jest mapowany
+// w pamięci, a tor jest budowany dopiero przy pierwszym użyciu.
+class TrackLibrary {
+public:
+    TrackLibrary() = default;
+    ~TrackLibrary();
+    TrackLibrary(const TrackLibrary&) = delete;
+    TrackLibrary& operator=(const TrackLibrary&) = delete;
+
+    static bool build(const std::vector<Track>& tracks, const std::string& filepath);
+
+    bool open(const std::string& filepath);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    size_t size() const { return trackCount; }
+    TrackInfo info(size_t index) const;
+    long find(std::string_view name) const;
+
+    // nullptr, gdy segmenty nie zgadzają się z sumą kontrolną z indeksu
+    const Track* track(size_t index);
+
+private:
+    std::string path;
+    const unsigned char* data = nullptr;
+    size_t dataSize = 0;
+    size_t trackCount = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    std::mutex cacheMutex;
+    std::unordered_map<size_t, std::unique_ptr<Track>> compiled;
+};
@@ -0,0 +1,121 @@
+#ifndef F1SIM_H
+#define F1SIM_H
+
+/*
+ * Stabilne API C biblioteki libf1sim.
+ *
+ * Konfiguracja i tor są wczytywane raz do uchwytów. Uchwyt f1sim_batch
+ * przechowuje przestrzeń roboczą wyścigu, więc kolejne wywołania
+ * f1sim_batch_run nie alokują pamięci i nie używają strumieni.
+ * Wyniki trafiają do tablic dostarczonych przez wywołującego.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(F1SIM_BUILD)
+#    define F1SIM_API __declspec(dllexport)
+#  else
+#    define F1SIM_API __declspec(dllimport)
+#  endif
+#else
+#  define F1SIM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define F1SIM_API_VERSION 1
+
+typedef enum f1sim_status {
+    F1SIM_OK = 0,
+    F1SIM_ERROR_ARGUMENT = -1,
+    F1SIM_ERROR_IO = -2,
+    F1SIM_ERROR_INTERNAL = -3
+} f1sim_status;
+
+typedef enum f1sim_weather {
+    F1SIM_WEATHER_SUNNY = 0,
+    F1SIM_WEATHER_CLOUDY = 1,
+    F1SIM_WEATHER_RAINY = 2,
+    F1SIM_WEATHER_STORM = 3
+} f1sim_weather;
+
+typedef struct f1sim_config f1sim_config;
+typedef struct f1sim_track f1sim_track;
+typedef struct f1sim_batch f1sim_batch;
+typedef struct f1sim_library f1sim_library;
+
+/*
+ * Bufory wyników dla `race_count` wyścigów. Wiersze są indeksowane
+ * numerem kierowcy w kolejności z pliku konfiguracyjnego
+ * (f1sim_config_driver_name). Każdy wskaźnik może być NULL.
+ *
+ *   positions       [race][driver]               pozycja na mecie, od 1
+ *   grid_positions  [race][driver]               pole startowe, od 1
+ *   finish_times    [race][driver]               czas ukończenia [s]
+ *   lap_times       [race][driver][laps]         czasy okrążeń [s]
+ *   pit_counts      [race][driver]               liczba zjazdów do boksu
+ *   pit_laps        [race][driver][max_pit_laps] okrążenia zjazdów, reszta = 0
+ */
+typedef struct f1sim_results {
+    int32_t* positions;
+    int32_t* grid_positions;
+    double* finish_times;
+    double* lap_times;
+    int32_t* pit_counts;
+    int32_t* pit_laps;
+    int32_t max_pit_laps;
+} f1sim_results;
+
+F1SIM_API int f1sim_api_version(void);
+
+F1SIM_API f1sim_status f1sim_config_load(const char* path, f1sim_config** out);
+F1SIM_API void f1sim_config_free(f1sim_config* config);
+F1SIM_API int f1sim_config_driver_count(const f1sim_config* config);
+F1SIM_API const char* f1sim_config_driver_name(const f1sim_config* config, int index);
+F1SIM_API const char* f1sim_config_driver_team(const f1sim_config* config, int index);
+F1SIM_API int f1sim_config_laps(const f1sim_config* config);
+
+F1SIM_API f1sim_status f1sim_track_load(const char* path, f1sim_track** out);
+F1SIM_API void f1sim_track_free(f1sim_track* track);
+F1SIM_API const char* f1sim_track_name(const f1sim_track* track);
+F1SIM_API double f1sim_track_length(const f1sim_track* track);
+
+/* Biblioteka torów (.f1lib) mapowana w pamięci; tory budowane przy pierwszym użyciu. */
+F1SIM_API f1sim_status f1sim_library_open(const char* path, f1sim_library** out);
+F1SIM_API void f1sim_library_free(f1sim_library* library);
+F1SIM_API int f1sim_library_track_count(const f1sim_library* library);
+F1SIM_API int f1sim_library_find(const f1sim_library* library, const char* name);
+/* Nazwa zakończona zerem, ważna do zwolnienia biblioteki; `length` (opcjonalnie,
+ * może być NULL) otrzymuje jej długość bez zera. NULL dla uszkodzonego wpisu. */
+F1SIM_API const char* f1sim_library_track_name(const f1sim_library* library, int index, size_t* length);
+F1SIM_API f1sim_status f1sim_library_load_track(f1sim_library* library, int index, f1sim_track** out);
+
+/* laps <= 0 oznacza liczbę okrążeń z konfiguracji. Uchwyty config i track
+ * mogą zostać zwolnione po utworzeniu batcha. */
+F1SIM_API f1sim_status f1sim_batch_create(const f1sim_config* config, const f1sim_track* track,
+                                          int laps, f1sim_weather weather, f1sim_batch** out);
+F1SIM_API void f1sim_batch_free(f1sim_batch* batch);
+F1SIM_API int f1sim_batch_laps(const f1sim_batch* batch);
+F1SIM_API int f1sim_batch_driver_count(const f1sim_batch* batch);
+
+/* Liczba wątków dzielących bolidy w obrębie jednego kroku (domyślnie 1).
+ * Wyniki są identyczne dla każdej liczby wątków; przy threads > 1 pula
+ * wątków powstaje w tym wywołaniu i obsługuje wszystkie kolejne wyścigi
+ * batcha (bez tworzenia wątków i alokacji na wyścig). Gdy wątków nie da się
+ * utworzyć, zwraca F1SIM_ERROR_INTERNAL, a batch liczy dalej w jednym wątku. */
+F1SIM_API f1sim_status f1sim_batch_set_step_threads(f1sim_batch* batch, int threads);
+
+/* Symuluje wyścigi o ziarnach first_seed .. first_seed + race_count - 1.
+ * Wynik dla danego ziarna jest identyczny z pełną symulacją simulateRace. */
+F1SIM_API f1sim_status f1sim_batch_run(f1sim_batch* batch, uint32_t first_seed, int race_count,
+                                       const f1sim_results* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,16 +1,46 @@
 #include "../include/Car.h"
+#include "../include/Hash.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
 
 Car::Car(const Driver& d, const Team& t, int startGridPosition) : driver(d), team(t) {
+    placeOnGrid(startGridPosition);
+}
+
+void Car::placeOnGrid(int startGridPosition) {
+    gridPosition = startGridPosition;
     totalDistance = -static_cast<double>(startGridPosition) * 8.0;
     lapDistance = totalDistance;
 }
 
-void Car::update(double dt, const Track& track, int totalLaps, WeatherType weather, std::mt19937& rng, const Car* carAhead) {
+void Car::reserveHistory(int totalLaps) {
+    lapTimes.reserve(totalLaps);
+    pitLaps.reserve(totalLaps);
+}
+
+uint64_t Car::randomKey(unsigned int raceSeed) const {
+    // Własny strumień losowy bolidu, więc wynik nie zależy od kolejności
+    // aktualizacji ani liczby wątków
+    return mix64(fnv1a(driver.name) + 0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(raceSeed) + 1));
+}
+
+CarSnapshot Car::snapshot() const {
+    return CarSnapshot{totalDistance, currentSpeed, driver.pace, driver.racecraft, finished};
+}
+
+void Car::update(double dt, const Track& track, int totalLaps, WeatherType weather, const RandomBlock& random,
+                 const CarSnapshot* carAhead) {
     if (finished) return;
 
+    lapTimer += dt;
+
+    // Liczby losowe kroku wyliczone z góry dla wszystkich bolidów - i-ty krok bolidu
+    // zawsze dostaje te same, więc wyścigi o tym samym ziarnie pozostają sparowane
+    const double* rolls = random.stepUniforms(stream);
+    double mistakeRoll = rolls[0];
+    double overtakeRoll = rolls[1];
+
     if (pitStopTimer > 0) {
         pitStopTimer -= dt;
         if (pitStopTimer <= 0) {
@@ -21,11 +51,10 @@ void Car::update(double dt, const Track& track, int totalLaps, WeatherType weath
         return;
     }
 
-    std::uniform_real_distribution<> dist01(0.0, 1.0);
     double mistakeProb = 0.005 * (1.0 - (driver.awareness / 100.0));
     
     bool mistakeMade = false;
-    if (dist01(rng) < mistakeProb) {
+    if (mistakeRoll < mistakeProb) {
         currentSpeed *= 0.85; 
         tireHealth -= 0.02;
         mistakeMade = true;
@@ -74,22 +103,22 @@ void Car::update(double dt, const Track& track, int totalLaps, WeatherType weath
     }
 
     if (carAhead && !mistakeMade) {
-        double distToAhead = carAhead->getTotalDistance() - totalDistance;
+        double distToAhead = carAhead->totalDistance - totalDistance;
         
         if (distToAhead > 0 && distToAhead < 25.0) {
             if (currentSeg->type == "CORNER") {
                 targetSpeed *= 0.95; 
             }
 
-            if (currentSpeed > carAhead->getCurrentSpeed()) {
-                double paceDiff = (driver.pace - carAhead->getDriver().pace) / 100.0;
-                double skillDiff = (driver.racecraft - carAhead->getDriver().racecraft) / 100.0;
+            if (currentSpeed > carAhead->currentSpeed) {
+                double paceDiff = (driver.pace - carAhead->pace) / 100.0;
+                double skillDiff = (driver.racecraft - carAhead->racecraft) / 100.0;
                 
                 double overtakeChance = 0.1 + paceDiff + skillDiff; 
                 if (currentSeg->type == "STRAIGHT") overtakeChance += 0.3;
 
-                if (dist01(rng) > overtakeChance) {
-                    targetSpeed = std::min(targetSpeed, carAhead->getCurrentSpeed());
+                if (overtakeRoll > overtakeChance) {
+                    targetSpeed = std::min(targetSpeed, carAhead->currentSpeed);
                 }
             }
         }
@@ -122,6 +151,12 @@ void Car::update(double dt, const Track& track, int totalLaps, WeatherType weath
 
         lapDistance -= track.totalLength;
         currentLap++;
+
+        // Czas okrążenia z korektą o dystans przejechany za linią mety
+        double overshootTime = lapDistance / std::max(currentSpeed, 1.0);
+        if (overshootTime > dt) overshootTime = dt;
+        lapTimes.push_back(lapTimer - overshootTime);
+        lapTimer = overshootTime;
         
         if (!finished) {
             // Strategia "Co-Jeśli"
@@ -129,8 +164,8 @@ void Car::update(double dt, const Track& track, int totalLaps, WeatherType weath
             
             // Rozważ zjazd do boksu tylko, jeśli zużycie jest znaczne lub z powodów strategicznych
             if (lapsRemaining > 0) {
-                std::normal_distribution<> pitDist(22.0 * team.pitStopMultiplier, 1.5);
-                double estimatedPitTime = pitDist(rng); 
+                // currentLap - 2: indeks (od 0) właśnie ukończonego okrążenia
+                double estimatedPitTime = 22.0 * team.pitStopMultiplier + 1.5 * random.lapNormals(stream)[currentLap - 2];
                 if (estimatedPitTime < 15.0) estimatedPitTime = 15.0;
 
                 // Proste oszacowanie czasu okrążenia (śr. prędkość ~60m/s)
@@ -174,6 +209,7 @@ void Car::update(double dt, const Track& track, int totalLaps, WeatherType weath
                 // Wymuś zjazd również, jeśli stan opon jest niebezpieczny (< 20%)
                 if (tireHealth < 0.25 || timePitNow < (timeKeepGoing - 1.0)) {
                     pitStopTimer = estimatedPitTime;
+                    pitLaps.push_back(currentLap - 1);
                 }
             }
         }
@@ -7,6 +7,31 @@
 
 ConfigParser::ConfigParser() {}
 
+std::string ConfigParser::locateConfigDir() {
+    std::string configDir = "config";
+    if (!std::filesystem::exists(configDir)) {
+        if (std::filesystem::exists("../config")) configDir = "../config";
+        else if (std::filesystem::exists("../../config")) configDir = "../../config";
+    }
+    return configDir;
+}
+
+WeatherType ConfigParser::parseWeather(const std::string& name) {
+    if (name == "Cloudy") return WeatherType::Cloudy;
+    if (name == "Rainy") return WeatherType::Rainy;
+    if (name == "Storm") return WeatherType::Storm;
+    return WeatherType::Sunny;
+}
+
+std::string ConfigParser::weatherName(WeatherType weather) {
+    switch (weather) {
+        case WeatherType::Cloudy: return "Cloudy";
+        case WeatherType::Rainy: return "Rainy";
+        case WeatherType::Storm: return "Storm";
+        default: return "Sunny";
+    }
+}
+
 std::vector<std::string> ConfigParser::split(const std::string& s, char delimiter) {
     std::vector<std::string> tokens;
     std::string token;
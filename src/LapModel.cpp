@@ -0,0 +1,462 @@
+#include "../include/LapModel.h"
+#include "../include/ConfigParser.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace {
+
+struct LapSamples {
+    std::string teamName;
+    double pitStopMultiplier = 1.0;
+    std::vector<double> ages;
+    std::vector<double> times;
+    std::vector<double> firstLaps;
+    std::vector<int> firstLapGrid;
+    std::vector<double> pitOutLaps;
+    std::vector<double> stints;
+    int minLapsRemaining = std::numeric_limits<int>::max();
+};
+
+double mean(const std::vector<double>& v) {
+    if (v.empty()) return 0.0;
+    double sum = 0.0;
+    for (double x : v) sum += x;
+    return sum / v.size();
+}
+
+double stdDev(const std::vector<double>& v) {
+    if (v.size() < 2) return 0.0;
+    double m = mean(v);
+    double sum = 0.0;
+    for (double x : v) sum += (x - m) * (x - m);
+    return std::sqrt(sum / (v.size() - 1));
+}
+
+DriverLapModel averageModel(const std::vector<DriverLapModel>& models) {
+    DriverLapModel avg{"", "", 0, 0, 0, 0, 0, 0, 0, 0};
+    if (models.empty()) return avg;
+    for (const auto& m : models) {
+        avg.baseLapTime += m.baseLapTime;
+        avg.tireDegradation += m.tireDegradation;
+        avg.lapTimeSigma += m.lapTimeSigma;
+        avg.firstLapDelta += m.firstLapDelta;
+        avg.pitLoss += m.pitLoss;
+        avg.stintLength += m.stintLength;
+        avg.stintSigma += m.stintSigma;
+        avg.minLapsRemaining += m.minLapsRemaining;
+    }
+    double n = models.size();
+    avg.baseLapTime /= n;
+    avg.tireDegradation /= n;
+    avg.lapTimeSigma /= n;
+    avg.firstLapDelta /= n;
+    avg.pitLoss /= n;
+    avg.stintLength /= n;
+    avg.stintSigma /= n;
+    avg.minLapsRemaining = static_cast<int>(avg.minLapsRemaining / n);
+    return avg;
+}
+
+}
+
+LapModel LapModel::calibrate(const RaceSetup& setup, int races, unsigned int firstSeed) {
+    std::map<std::string, LapSamples> samples;
+    std::map<std::string, double> pitMultipliers;
+    for (const auto& t : setup.teams) pitMultipliers[t.name] = t.pitStopMultiplier;
+
+    for (int r = 0; r < races; ++r) {
+        RaceResult result = simulateRace(setup, firstSeed + r);
+
+        for (const auto& car : result.classification) {
+            LapSamples& s = samples[car.driverName];
+            s.teamName = car.teamName;
+            s.pitStopMultiplier = pitMultipliers[car.teamName];
+
+            int lastPit = 0;
+            size_t nextPit = 0;
+            for (size_t i = 0; i < car.lapTimes.size(); ++i) {
+                int lap = i + 1;
+                while (nextPit < car.pitLaps.size() && car.pitLaps[nextPit] < lap) {
+                    lastPit = car.pitLaps[nextPit++];
+                }
+
+                if (lap == 1) {
+                    s.firstLaps.push_back(car.lapTimes[i]);
+                    s.firstLapGrid.push_back(car.gridPosition - 1);
+                } else if (lastPit > 0 && lastPit == lap - 1) {
+                    s.pitOutLaps.push_back(car.lapTimes[i]);
+                } else {
+                    s.ages.push_back(lap - 1 - lastPit);
+                    s.times.push_back(car.lapTimes[i]);
+                }
+            }
+
+            int previous = 0;
+            for (int pit : car.pitLaps) {
+                s.stints.push_back(pit - previous);
+                s.minLapsRemaining = std::min(s.minLapsRemaining, setup.laps - pit);
+                previous = pit;
+            }
+        }
+    }
+
+    LapModel model;
+    model.trackName = setup.track.name;
+    model.weather = setup.weather;
+    model.laps = setup.laps;
+    model.calibrationRaces = races;
+
+    // Regresja liniowa czasu okrążenia względem wieku opon
+    for (const auto& [name, s] : samples) {
+        DriverLapModel m;
+        m.driverName = name;
+        m.teamName = s.teamName;
+
+        double meanAge = mean(s.ages);
+        double meanTime = mean(s.times);
+        double cov = 0.0, var = 0.0;
+        for (size_t i = 0; i < s.ages.size(); ++i) {
+            cov += (s.ages[i] - meanAge) * (s.times[i] - meanTime);
+            var += (s.ages[i] - meanAge) * (s.ages[i] - meanAge);
+        }
+        m.tireDegradation = (var > 0) ? cov / var : 0.0;
+        m.baseLapTime = meanTime - m.tireDegradation * meanAge;
+
+        double residuals = 0.0;
+        for (size_t i = 0; i < s.ages.size(); ++i) {
+            double e = s.times[i] - (m.baseLapTime + m.tireDegradation * s.ages[i]);
+            residuals += e * e;
+        }
+        m.lapTimeSigma = (s.ages.size() > 2) ? std::sqrt(residuals / (s.ages.size() - 2)) : 0.0;
+
+        if (!s.pitOutLaps.empty()) m.pitLoss = mean(s.pitOutLaps) - m.baseLapTime;
+        else m.pitLoss = 22.0 * s.pitStopMultiplier;
+
+        m.stintLength = mean(s.stints);
+        m.stintSigma = stdDev(s.stints);
+        m.minLapsRemaining = s.stints.empty() ? 0 : s.minLapsRemaining;
+        m.firstLapDelta = 0.0;
+        model.drivers.push_back(m);
+    }
+
+    // Strata na polu startowym wspólna dla stawki, reszta straty startowej per kierowca
+    std::vector<double> gridIdx, firstLoss;
+    for (const auto& m : model.drivers) {
+        const LapSamples& s = samples[m.driverName];
+        for (size_t i = 0; i < s.firstLaps.size(); ++i) {
+            gridIdx.push_back(s.firstLapGrid[i]);
+            firstLoss.push_back(s.firstLaps[i] - m.baseLapTime);
+        }
+    }
+    double meanGrid = mean(gridIdx);
+    double meanLoss = mean(firstLoss);
+    double cov = 0.0, var = 0.0;
+    for (size_t i = 0; i < gridIdx.size(); ++i) {
+        cov += (gridIdx[i] - meanGrid) * (firstLoss[i] - meanLoss);
+        var += (gridIdx[i] - meanGrid) * (gridIdx[i] - meanGrid);
+    }
+    model.gridSlotTime = (var > 0) ? std::max(0.0, cov / var) : 0.0;
+
+    for (auto& m : model.drivers) {
+        const LapSamples& s = samples[m.driverName];
+        std::vector<double> deltas;
+        for (size_t i = 0; i < s.firstLaps.size(); ++i) {
+            deltas.push_back(s.firstLaps[i] - m.baseLapTime - model.gridSlotTime * s.firstLapGrid[i]);
+        }
+        m.firstLapDelta = mean(deltas);
+    }
+
+    model.fallback = averageModel(model.drivers);
+    return model;
+}
+
+const DriverLapModel* LapModel::findExact(const std::string& driverName, const std::string& teamName) const {
+    for (const auto& m : drivers) {
+        if (m.driverName == driverName && m.teamName == teamName) return &m;
+    }
+    return nullptr;
+}
+
+const DriverLapModel& LapModel::find(const std::string& driverName, const std::string& teamName) const {
+    const DriverLapModel* m = findExact(driverName, teamName);
+    return m ? *m : fallback;
+}
+
+bool LapModel::matchesRace(const RaceSetup& setup) const {
+    return trackName == setup.track.name && weather == setup.weather && laps == setup.laps;
+}
+
+bool LapModel::compatible(const RaceSetup& setup) const {
+    if (!matchesRace(setup)) {
+        std::cerr << "Lap model calibrated for " << trackName << " (" << ConfigParser::weatherName(weather)
+                  << ", " << laps << " laps) does not match race on " << setup.track.name << " ("
+                  << ConfigParser::weatherName(setup.weather) << ", " << setup.laps << " laps) - recalibrate it." << std::endl;
+        return false;
+    }
+    for (const auto& d : setup.drivers) {
+        if (!findExact(d.name, d.teamName)) {
+            std::cerr << "Warning: no lap model for " << d.name << " (" << d.teamName
+                      << "), using the field average." << std::endl;
+        }
+    }
+    return true;
+}
+
+RaceResult LapModel::simulate(const RaceSetup& setup, unsigned int seed) const {
+    if (!matchesRace(setup)) return RaceResult{seed, {}};
+
+    std::mt19937 gen(seed);
+    auto grid = simulateQualifying(setup.drivers, setup.teams, setup.track, gen);
+
+    std::normal_distribution<> unit(0.0, 1.0);
+    std::uniform_real_distribution<> dist01(0.0, 1.0);
+
+    struct CarState {
+        const DriverLapModel* model;
+        const Driver* driver;
+        double time = 0.0;
+        double nextTime = 0.0;
+        int tireAge = 0;
+        double stintTarget = 0.0;
+        bool pitting = false;
+        CarResult result;
+    };
+
+    auto drawStint = [&](const DriverLapModel& m) {
+        if (m.stintLength <= 0) return std::numeric_limits<double>::max();
+        return std::max(1.0, std::round(m.stintLength + m.stintSigma * unit(gen)));
+    };
+
+    std::vector<CarState> cars(grid.size());
+    std::vector<size_t> order(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) {
+        cars[i].model = &find(grid[i].driver.name, grid[i].team.name);
+        cars[i].driver = &grid[i].driver;
+        cars[i].stintTarget = drawStint(*cars[i].model);
+        cars[i].result.driverName = grid[i].driver.name;
+        cars[i].result.teamName = grid[i].team.name;
+        cars[i].result.gridPosition = i + 1;
+        cars[i].result.lapTimes.reserve(setup.laps);
+        order[i] = i;
+    }
+
+    for (int lap = 1; lap <= setup.laps; ++lap) {
+        for (size_t i = 0; i < cars.size(); ++i) {
+            CarState& c = cars[i];
+            const DriverLapModel& m = *c.model;
+            double lapTime = m.baseLapTime + m.tireDegradation * c.tireAge + m.lapTimeSigma * unit(gen);
+            if (lap == 1) lapTime += m.firstLapDelta + gridSlotTime * i;
+            if (c.pitting) lapTime += m.pitLoss;
+            c.nextTime = c.time + lapTime;
+        }
+
+        // Ruch na torze: szybszy bolid za plecami rywala próbuje wyprzedzić raz na okrążenie
+        for (size_t k = 1; k < order.size(); ++k) {
+            CarState& c = cars[order[k]];
+            CarState& ahead = cars[order[k - 1]];
+            if (c.pitting || ahead.pitting) continue;
+            if (lap > 1 && c.time - ahead.time > trafficWindow) continue;
+            if (c.nextTime >= ahead.nextTime + minGap) continue;
+
+            double paceDiff = (c.driver->pace - ahead.driver->pace) / 100.0;
+            double skillDiff = (c.driver->racecraft - ahead.driver->racecraft) / 100.0;
+            double overtakeChance = std::clamp(0.4 + paceDiff + skillDiff, 0.05, 0.95);
+
+            if (dist01(gen) > overtakeChance) {
+                c.nextTime = ahead.nextTime + minGap;
+            }
+        }
+
+        for (auto& c : cars) {
+            c.result.lapTimes.push_back(c.nextTime - c.time);
+            c.time = c.nextTime;
+            c.tireAge++;
+            c.pitting = false;
+
+            int lapsRemaining = setup.laps - lap;
+            if (lapsRemaining > 0 && c.tireAge >= c.stintTarget && lapsRemaining >= c.model->minLapsRemaining) {
+                c.pitting = true;
+                c.tireAge = 0;
+                c.stintTarget = drawStint(*c.model);
+                c.result.pitLaps.push_back(lap);
+            }
+        }
+
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return cars[a].time < cars[b].time;
+        });
+    }
+
+    RaceResult result;
+    result.seed = seed;
+    result.classification.reserve(cars.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        CarState& c = cars[order[k]];
+        c.result.finishPosition = k + 1;
+        c.result.finishTime = c.time;
+        result.classification.push_back(std::move(c.result));
+    }
+    return result;
+}
+
+LapModelAccuracy LapModel::evaluate(const LapModel& model, const RaceSetup& setup, int races, unsigned int firstSeed) {
+    struct Totals {
+        double fullPos = 0, modelPos = 0, fullTime = 0, modelTime = 0;
+    };
+    std::map<std::string, Totals> totals;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < races; ++r) {
+        for (const auto& c : simulateRace(setup, firstSeed + r).classification) {
+            totals[c.driverName].fullPos += c.finishPosition;
+            totals[c.driverName].fullTime += c.finishTime;
+        }
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int r = 0; r < races; ++r) {
+        for (const auto& c : model.simulate(setup, firstSeed + r).classification) {
+            totals[c.driverName].modelPos += c.finishPosition;
+            totals[c.driverName].modelTime += c.finishTime;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    LapModelAccuracy report;
+    report.fullSeconds = std::chrono::duration<double>(mid - start).count();
+    report.modelSeconds = std::chrono::duration<double>(end - mid).count();
+    report.meanAbsPositionError = 0.0;
+    report.meanRelTimeError = 0.0;
+    report.rankCorrelation = 0.0;
+
+    for (const auto& [name, t] : totals) {
+        LapModelAccuracy::DriverRow row;
+        row.driverName = name;
+        row.fullMeanPosition = t.fullPos / races;
+        row.modelMeanPosition = t.modelPos / races;
+        row.fullMeanTime = t.fullTime / races;
+        row.modelMeanTime = t.modelTime / races;
+        report.drivers.push_back(row);
+    }
+    if (report.drivers.empty()) return report;
+
+    std::sort(report.drivers.begin(), report.drivers.end(), [](const auto& a, const auto& b) {
+        return a.fullMeanPosition < b.fullMeanPosition;
+    });
+
+    // Korelacja rang Spearmana średnich pozycji
+    std::vector<size_t> byModel(report.drivers.size());
+    for (size_t i = 0; i < byModel.size(); ++i) byModel[i] = i;
+    std::sort(byModel.begin(), byModel.end(), [&](size_t a, size_t b) {
+        return report.drivers[a].modelMeanPosition < report.drivers[b].modelMeanPosition;
+    });
+
+    double n = report.drivers.size();
+    double sumSq = 0.0;
+    for (size_t rank = 0; rank < byModel.size(); ++rank) {
+        double d = static_cast<double>(rank) - static_cast<double>(byModel[rank]);
+        sumSq += d * d;
+    }
+    report.rankCorrelation = (n > 1) ? 1.0 - 6.0 * sumSq / (n * (n * n - 1)) : 1.0;
+
+    for (const auto& row : report.drivers) {
+        report.meanAbsPositionError += std::abs(row.modelMeanPosition - row.fullMeanPosition) / n;
+        if (row.fullMeanTime > 0) {
+            report.meanRelTimeError += std::abs(row.modelMeanTime - row.fullMeanTime) / row.fullMeanTime / n;
+        }
+    }
+    return report;
+}
+
+bool LapModel::save(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Error saving lap model: " << filepath << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(10);
+    file << "[LapModel]\n";
+    file << "Track=" << trackName << "\n";
+    file << "Weather=" << ConfigParser::weatherName(weather) << "\n";
+    file << "Laps=" << laps << "\n";
+    file << "CalibrationRaces=" << calibrationRaces << "\n";
+    file << "GridSlotTime=" << gridSlotTime << "\n";
+    file << "TrafficWindow=" << trafficWindow << "\n";
+    file << "MinGap=" << minGap << "\n";
+    file << "\n[Drivers]\n";
+    file << "# Name,Team,BaseLapTime,TireDegradation,LapTimeSigma,FirstLapDelta,PitLoss,StintLength,StintSigma,MinLapsRemaining\n";
+    for (const auto& m : drivers) {
+        file << m.driverName << "," << m.teamName << "," << m.baseLapTime << "," << m.tireDegradation << ","
+             << m.lapTimeSigma << "," << m.firstLapDelta << "," << m.pitLoss << "," << m.stintLength << ","
+             << m.stintSigma << "," << m.minLapsRemaining << "\n";
+    }
+    return true;
+}
+
+bool LapModel::load(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Error loading lap model: " << filepath << std::endl;
+        return false;
+    }
+
+    drivers.clear();
+    laps = 0;
+    std::string line;
+    std::string currentSection;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line[0] == '[') {
+            size_t end = line.find(']');
+            if (end != std::string::npos) currentSection = line.substr(1, end - 1);
+            continue;
+        }
+
+        if (currentSection == "LapModel") {
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+
+            if (key == "Track") trackName = value;
+            else if (key == "Weather") weather = ConfigParser::parseWeather(value);
+            else if (key == "Laps") laps = std::stoi(value);
+            else if (key == "CalibrationRaces") calibrationRaces = std::stoi(value);
+            else if (key == "GridSlotTime") gridSlotTime = std::stod(value);
+            else if (key == "TrafficWindow") trafficWindow = std::stod(value);
+            else if (key == "MinGap") minGap = std::stod(value);
+        } else if (currentSection == "Drivers") {
+            std::vector<std::string> tokens;
+            std::string token;
+            std::istringstream tokenStream(line);
+            while (std::getline(tokenStream, token, ',')) tokens.push_back(token);
+            if (tokens.size() < 10) continue;
+
+            DriverLapModel m;
+            m.driverName = tokens[0];
+            m.teamName = tokens[1];
+            m.baseLapTime = std::stod(tokens[2]);
+            m.tireDegradation = std::stod(tokens[3]);
+            m.lapTimeSigma = std::stod(tokens[4]);
+            m.firstLapDelta = std::stod(tokens[5]);
+            m.pitLoss = std::stod(tokens[6]);
+            m.stintLength = std::stod(tokens[7]);
+            m.stintSigma = std::stod(tokens[8]);
+            m.minLapsRemaining = std::stoi(tokens[9]);
+            drivers.push_back(m);
+        }
+    }
+
+    fallback = averageModel(drivers);
+    return !drivers.empty();
+}
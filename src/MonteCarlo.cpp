@@ -0,0 +1,179 @@
+#include "../include/MonteCarlo.h"
+#include "../include/LapModel.h"
+#include "../include/ResultCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+// Bisekcja po erf
+double twoSidedZ(double confidence) {
+    double lo = 0.0, hi = 10.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (std::erf(mid / std::sqrt(2.0)) < confidence) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+void RunningStat::add(double x) {
+    n += 1.0;
+    double delta = x - mean;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+}
+
+void parallelFor(int count, int threads, const std::function<void(int)>& job) {
+    std::atomic<int> next{0};
+    auto work = [&]() {
+        for (int i = next++; i < count; i = next++) job(i);
+    };
+
+    int workers = std::min(std::max(threads, 1), count);
+    std::vector<std::jthread> pool;
+    for (int w = 1; w < workers; ++w) pool.emplace_back(work);
+    work();
+}
+
+int sampleBatches(const SamplingLimits& limits, const std::function<void(unsigned int, int)>& runBatch,
+                  const std::function<bool(int, double)>& converged, double& seconds) {
+    auto start = std::chrono::steady_clock::now();
+    int batchSize = std::max(limits.batchSize, 1);
+    int races = 0;
+
+    while (races < limits.maxRaces) {
+        int count = std::min(batchSize, limits.maxRaces - races);
+        runBatch(limits.firstSeed + races, count);
+        races += count;
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (races >= limits.minRaces && converged(races, elapsed)) break;
+        if (limits.timeBudgetSeconds > 0 && elapsed >= limits.timeBudgetSeconds) break;
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return races;
+}
+
+AdaptiveSampler::AdaptiveSampler(const RaceSetup& s, const MonteCarloOptions& o)
+    : setup(s), options(o) {
+    if (options.targets.empty()) {
+        options.targets = {
+            {MonteCarloMetric::WinProbability, 0.01},
+            {MonteCarloMetric::PodiumProbability, 0.01},
+            {MonteCarloMetric::MeanPosition, 0.1}
+        };
+    }
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (options.batchSize <= 0) options.batchSize = 1;
+    if (options.fidelity == SimFidelity::LapModel && (!options.lapModel || !options.lapModel->compatible(setup))) {
+        std::cerr << "Falling back to full simulation." << std::endl;
+        options.fidelity = SimFidelity::Full;
+    }
+
+    z = twoSidedZ(options.confidence);
+    wins.resize(setup.drivers.size());
+    podiums.resize(setup.drivers.size());
+    positions.resize(setup.drivers.size());
+}
+
+void AdaptiveSampler::runBatch(unsigned int firstSeed, int count, std::vector<int>& finishPositions) const {
+    size_t n = setup.drivers.size();
+    finishPositions.assign(count * n, 0);
+
+    std::unordered_map<std::string, size_t> driverIndex;
+    for (size_t i = 0; i < n; ++i) driverIndex[setup.drivers[i].name] = i;
+
+    if (options.cache && options.fidelity == SimFidelity::Full) {
+        auto results = options.cache->run(setup, firstSeed, count, options.threads);
+        for (int r = 0; r < count; ++r) {
+            for (const auto& c : results[r].classification) {
+                finishPositions[r * n + driverIndex.at(c.driverName)] = c.finishPosition;
+            }
+        }
+        return;
+    }
+
+    parallelFor(count, options.threads, [&](int r) {
+        RaceResult result = (options.fidelity == SimFidelity::LapModel)
+            ? options.lapModel->simulate(setup, firstSeed + r)
+            : simulateRace(setup, firstSeed + r);
+
+        for (const auto& c : result.classification) {
+            finishPositions[r * n + driverIndex.at(c.driverName)] = c.finishPosition;
+        }
+    });
+}
+
+MonteCarloReport AdaptiveSampler::run() {
+    size_t n = setup.drivers.size();
+    std::vector<int> finishPositions;
+
+    SamplingLimits limits{options.batchSize, options.minRaces, options.maxRaces, options.timeBudgetSeconds, options.firstSeed};
+    double seconds = 0.0;
+    int races = sampleBatches(limits, [&](unsigned int firstSeed, int count) {
+        runBatch(firstSeed, count, finishPositions);
+
+        // Scalanie w kolejności ziaren - wynik nie zależy od liczby wątków
+        for (int r = 0; r < count; ++r) {
+            for (size_t d = 0; d < n; ++d) {
+                int pos = finishPositions[r * n + d];
+                wins[d].add(pos == 1 ? 1.0 : 0.0);
+                podiums[d].add(pos <= 3 ? 1.0 : 0.0);
+                positions[d].add(pos);
+            }
+        }
+    }, [&](int done, double elapsed) { return buildReport(done, elapsed).converged; }, seconds);
+
+    return buildReport(races, seconds);
+}
+
+Estimate AdaptiveSampler::proportion(const RunningStat& s) const {
+    // Przedział Wilsona - nie zapada się do zera dla p = 0 lub p = 1
+    if (s.n <= 0) return {0.0, 1.0};
+    double p = s.mean;
+    double z2 = z * z;
+    double denom = 1.0 + z2 / s.n;
+    double halfWidth = z * std::sqrt(p * (1.0 - p) / s.n + z2 / (4.0 * s.n * s.n)) / denom;
+    return {p, halfWidth};
+}
+
+Estimate AdaptiveSampler::mean(const RunningStat& s) const {
+    if (s.n <= 1) return {s.mean, static_cast<double>(setup.drivers.size())};
+    return {s.mean, z * std::sqrt(s.variance() / s.n)};
+}
+
+MonteCarloReport AdaptiveSampler::buildReport(int races, double seconds) const {
+    MonteCarloReport report;
+    report.races = races;
+    report.seconds = seconds;
+    report.worstRatio = 0.0;
+
+    for (size_t d = 0; d < setup.drivers.size(); ++d) {
+        DriverEstimates e;
+        e.driverName = setup.drivers[d].name;
+        e.win = proportion(wins[d]);
+        e.podium = proportion(podiums[d]);
+        e.meanPosition = mean(positions[d]);
+
+        for (const auto& target : options.targets) {
+            const Estimate& est = (target.metric == MonteCarloMetric::WinProbability) ? e.win
+                                : (target.metric == MonteCarloMetric::PodiumProbability) ? e.podium
+                                : e.meanPosition;
+            double ratio = (target.halfWidth > 0) ? est.halfWidth / target.halfWidth : 0.0;
+            report.worstRatio = std::max(report.worstRatio, ratio);
+        }
+        report.drivers.push_back(e);
+    }
+
+    report.converged = report.worstRatio <= 1.0;
+
+    std::sort(report.drivers.begin(), report.drivers.end(), [](const DriverEstimates& a, const DriverEstimates& b) {
+        return a.meanPosition.value < b.meanPosition.value;
+    });
+    return report;
+}
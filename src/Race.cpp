@@ -4,56 +4,71 @@
 #include <thread>
 #include <chrono>
 #include <iomanip>
+#include <barrier>
+#include <random>
 
 
-Race::Race(const std::vector<Car>& c, const Track& t, int laps) 
-    : cars(c), track(t), totalLaps(laps) {
-    std::random_device rd;
-    rng.seed(rd());
+Race::Race(const std::vector<Car>& c, const Track& t, int laps, WeatherType w) 
+    : Race(c, t, laps, w, std::random_device{}()) {}
+
+Race::Race(const std::vector<Car>& c, const Track& t, int laps, WeatherType w, unsigned int s)
+    : cars(c), track(t), totalLaps(laps), weather(w), seed(s) {
+    seedCars();
+}
+
+void Race::seedCars() {
+    streamKeys.resize(cars.size());
+    for (size_t i = 0; i < cars.size(); ++i) {
+        cars[i].setRandomStream(i);
+        streamKeys[i] = cars[i].randomKey(seed);
+    }
+    random.reset(streamKeys, totalLaps);
+    step = 0;
 }
 
 void Race::run() {
-    double dt = 0.5; 
-    
     std::cout << "\033[2J\033[1;1H" << std::flush;
 
-    while (!raceFinished) {
-        bool allFinished = true;
+    RaceTask task = live(100);
+    while (task.resume()) {
+        printStatus();
+        
+        if (!raceFinished) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+    
+    std::cout << "\n\n   >>> RACE FINISHED! <<<\n";
+    updateLeaderboard();
+    printStatus();
+}
 
+void Race::reset(const std::vector<Car>& grid, unsigned int s) {
+    cars = grid;
+    for (auto& car : cars) car.reserveHistory(totalLaps);
+    seed = s;
+    seedCars();
+    raceTime = 0.0;
+    raceFinished = false;
+    resizePool();
+}
+
+void Race::runToFinish() {
+    // Wyścig bez wizualizacji - tabela aktualizowana w tym samym rytmie co w run()
+    while (!raceFinished) {
         int stepsPerFrame = 100;
 
-        for (int step = 0; step < stepsPerFrame; ++step) {
-            for (size_t i = 0; i < cars.size(); ++i) {
-                if (cars[i].getCurrentLap() <= totalLaps) {
-                    allFinished = false;
-                    
-                    const Car* carAhead = nullptr;
-                    if (i > 0) {
-                        if (!cars[i-1].hasFinished(totalLaps)) {
-                            carAhead = &cars[i-1];
-                        }
-                    }
-
-                    cars[i].update(dt, track, totalLaps, WeatherType::Sunny, rng, carAhead);
-                } else if (!cars[i].hasFinished(totalLaps)) {
-                    double expectedTotalDist = (double)totalLaps * track.totalLength;
-                    double overshoot = cars[i].getTotalDistance() - expectedTotalDist;
-                    
-                    double speed = cars[i].getCurrentSpeed();
-                    if (speed < 1.0) speed = 1.0;
-
-                    double timeCorrection = overshoot / speed;
-                    if (timeCorrection > dt) timeCorrection = dt;
-                    if (timeCorrection < 0) timeCorrection = 0;
-
-                    cars[i].completeRace(raceTime - timeCorrection);
-                }
-            }
-            raceTime += dt;
-            if (allFinished) break; 
-        }
-        
-        allFinished = true; 
+        if (advance(stepsPerFrame)) raceFinished = true;
+        updateLeaderboard();
+    }
+}
+
+RaceTask Race::live(int stepsPerFrame) {
+    while (!raceFinished) {
+        double frameStart = raceTime;
+        advance(stepsPerFrame);
+
+        bool allFinished = true; 
         for(const auto& car : cars) {
             if(!car.hasFinished(totalLaps)) {
                 allFinished = false; 
@@ -66,16 +81,211 @@ void Race::run() {
         }
 
         updateLeaderboard();
-        printStatus();
+        co_yield raceTime - frameStart;
+    }
+}
+
+RaceResult Race::simulate() {
+    runToFinish();
+    return getResult();
+}
+
+RaceResult Race::getResult() const {
+    RaceResult result;
+    result.seed = seed;
+    result.classification.reserve(cars.size());
+    for (size_t i = 0; i < cars.size(); ++i) {
+        CarResult r;
+        r.driverName = cars[i].getDriver().name;
+        r.teamName = cars[i].getTeam().name;
+        r.gridPosition = cars[i].getGridPosition() + 1;
+        r.finishPosition = i + 1;
+        r.finishTime = cars[i].getFinishTime();
+        r.lapTimes = cars[i].getLapTimes();
+        r.pitLaps = cars[i].getPitLaps();
+        result.classification.push_back(r);
+    }
+    return result;
+}
+
+void Race::takeSnapshots() {
+    snapshots.resize(cars.size());
+    for (size_t i = 0; i < cars.size(); ++i) {
+        snapshots[i] = cars[i].snapshot();
+    }
+}
+
+bool Race::stepCar(size_t i) {
+    if (cars[i].getCurrentLap() <= totalLaps) {
+        const CarSnapshot* carAhead = nullptr;
+        if (i > 0 && !snapshots[i-1].finished) {
+            carAhead = &snapshots[i-1];
+        }
+
+        cars[i].update(dt, track, totalLaps, weather, random, carAhead);
+        return true;
+    }
+
+    if (!cars[i].hasFinished(totalLaps)) {
+        double expectedTotalDist = (double)totalLaps * track.totalLength;
+        double overshoot = cars[i].getTotalDistance() - expectedTotalDist;
         
-        if (!raceFinished) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        double speed = cars[i].getCurrentSpeed();
+        if (speed < 1.0) speed = 1.0;
+
+        double timeCorrection = overshoot / speed;
+        if (timeCorrection > dt) timeCorrection = dt;
+        if (timeCorrection < 0) timeCorrection = 0;
+
+        cars[i].completeRace(raceTime - timeCorrection);
+    }
+    return false;
+}
+
+// Stała pula wątków kroku: bariera z bramką startu klatki, tworzona raz dla danej
+// liczby wątków i bolidów, więc kolejne klatki i wyścigi nie tworzą wątków ani nie alokują
+struct Race::StepPool {
+    struct Completion {
+        Race* race;
+        void operator()() noexcept { race->completeStep(); }
+    };
+
+    int workers;
+    std::vector<char> racing;
+    int requestedSteps = 0;     // zapis przed bramką startu, odczyt w jej domknięciu
+    int steps = 0;
+    int executed = 0;
+    bool starting = false;
+    bool done = false;
+    bool allFinished = false;
+    bool stopping = false;
+    std::barrier<Completion> sync;
+    std::vector<std::jthread> threads;
+
+    StepPool(Race* race, int n) : workers(n), racing(n, 0), sync(n, Completion{race}) {}
+};
+
+Race::~Race() {
+    stopPool();
+}
+
+void Race::setThreadCount(int threads) {
+    threadCount = threads;
+    resizePool();
+}
+
+void Race::resizePool() {
+    int workers = std::min<int>(threadCount, cars.size());
+    if (workers < 1) workers = 1;
+    if (workers == (pool ? pool->workers : 1)) return;
+
+    stopPool();
+    if (workers <= 1) return;
+
+    pool = std::make_unique<StepPool>(this, workers);
+    try {
+        for (int w = 1; w < workers; ++w) {
+            pool->threads.emplace_back([this, w]() { poolWorker(w); });
         }
+    } catch (...) {
+        // Niepełna pula: brakujący uczestnicy bramki startu odchodzą z bariery,
+        // uruchomione wątki kończą się, a wyścig wraca do kroku jednowątkowego
+        int missing = workers - 1 - static_cast<int>(pool->threads.size());
+        pool->stopping = true;
+        pool->starting = true;
+        for (int m = 0; m < missing; ++m) pool->sync.arrive_and_drop();
+        pool->sync.arrive_and_wait();
+        pool->threads.clear();
+        pool.reset();
+        throw;
     }
-    
-    std::cout << "\n\n   >>> RACE FINISHED! <<<\n";
-    updateLeaderboard();
-    printStatus();
+}
+
+void Race::stopPool() {
+    if (!pool) return;
+    pool->stopping = true;
+    pool->starting = true;
+    pool->sync.arrive_and_wait();
+    pool->threads.clear();
+    pool.reset();
+}
+
+void Race::poolWorker(int worker) {
+    while (true) {
+        // Bramka startu klatki - stan klatki zapisany przed nią przez advance()
+        pool->sync.arrive_and_wait();
+        if (pool->stopping) return;
+        while (!stepPartition(worker, pool->workers)) {}
+    }
+}
+
+bool Race::stepPartition(int worker, int workers) {
+    // Jeden krok ciągłego zakresu bolidów; true, gdy klatka się skończyła
+    size_t begin = cars.size() * worker / workers;
+    size_t end = cars.size() * (worker + 1) / workers;
+    bool anyRacing = false;
+    for (size_t i = begin; i < end; ++i) {
+        if (stepCar(i)) anyRacing = true;
+    }
+    pool->racing[worker] = anyRacing;
+    pool->sync.arrive_and_wait();
+    return pool->done;
+}
+
+void Race::completeStep() {
+    // Wykonywane przez jeden wątek po dojściu wszystkich do bariery
+    StepPool& p = *pool;
+    if (p.starting) {
+        // Stan klatki zmieniany tylko tutaj: wątek, który jeszcze nie odczytał `done`
+        // z poprzedniej klatki, nie może zobaczyć nowego stanu
+        p.starting = false;
+        p.steps = p.requestedSteps;
+        p.executed = 0;
+        p.done = false;
+        p.allFinished = false;
+        return;
+    }
+
+    raceTime += dt;
+    p.executed++;
+
+    p.allFinished = true;
+    for (char r : p.racing) {
+        if (r) p.allFinished = false;
+    }
+    p.done = p.allFinished || p.executed >= p.steps;
+    if (!p.done) {
+        takeSnapshots();
+        random.fillStep(step++);
+    }
+}
+
+bool Race::advance(int steps) {
+    // Podwójne buforowanie: w kroku każdy bolid czyta migawki z poprzedniego kroku,
+    // więc wynik nie zależy od kolejności ani liczby wątków
+    if (!pool) {
+        for (int s = 0; s < steps; ++s) {
+            takeSnapshots();
+            random.fillStep(step++);
+            bool anyRacing = false;
+            for (size_t i = 0; i < cars.size(); ++i) {
+                if (stepCar(i)) anyRacing = true;
+            }
+            raceTime += dt;
+            if (!anyRacing) return true;
+        }
+        return false;
+    }
+
+    StepPool& p = *pool;
+    p.requestedSteps = steps;
+    p.starting = true;
+    takeSnapshots();
+    random.fillStep(step++);
+
+    p.sync.arrive_and_wait();
+    while (!stepPartition(0, p.workers)) {}
+    return p.allFinished;
 }
 
 void Race::updateLeaderboard() {
@@ -0,0 +1,108 @@
+#include "../include/RaceScheduler.h"
+#include <iostream>
+
+RaceScheduler::RaceScheduler(int workerCount, int frameSteps) : stepsPerFrame(frameSteps) {
+    if (workerCount < 1) workerCount = 1;
+    for (int w = 0; w < workerCount; ++w) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+RaceScheduler::~RaceScheduler() {
+    stop();
+}
+
+int RaceScheduler::add(std::unique_ptr<Race> race, double speed, FrameCallback onFrame) {
+    auto entry = std::make_unique<Entry>();
+    entry->race = std::move(race);
+    entry->task = entry->race->live(stepsPerFrame);
+    entry->speed = speed;
+    entry->onFrame = std::move(onFrame);
+    entry->due = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    int id = nextId++;
+    entry->id = id;
+    ready.push(entry.get());
+    entries.emplace(id, std::move(entry));
+    running++;
+    wake.notify_one();
+    return id;
+}
+
+void RaceScheduler::setSpeed(int raceId, double speed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(raceId);
+    if (it != entries.end()) it->second->speed = speed;
+}
+
+void RaceScheduler::waitAll() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return running == 0 || stopping; });
+}
+
+void RaceScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    idle.notify_all();
+    workers.clear();
+}
+
+size_t RaceScheduler::runningCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return running;
+}
+
+size_t RaceScheduler::finishedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return finished;
+}
+
+void RaceScheduler::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (ready.empty()) {
+            wake.wait(lock);
+            continue;
+        }
+
+        Entry* entry = ready.top();
+        if (entry->due > Clock::now()) {
+            wake.wait_until(lock, entry->due);
+            continue;
+        }
+        ready.pop();
+        lock.unlock();
+
+        // Wyścig jest wznawiany tylko przez wątek, który zdjął go z kolejki
+        bool more = false;
+        try {
+            more = entry->task.resume() && !entry->race->isFinished();
+            if (!entry->task.done() && entry->onFrame) entry->onFrame(entry->id, *entry->race);
+        } catch (const std::exception& e) {
+            std::cerr << "Race " << entry->id << " aborted: " << e.what() << std::endl;
+            more = false;
+        }
+
+        lock.lock();
+        if (more) {
+            if (entry->speed > 0) {
+                auto frame = std::chrono::duration<double>(entry->task.frameTime() / entry->speed);
+                entry->due += std::chrono::duration_cast<Clock::duration>(frame);
+            } else {
+                entry->due = Clock::now();
+            }
+            ready.push(entry);
+            wake.notify_one();
+        } else {
+            // Ostatnie wywołanie zwrotne już było - zwolnij korutynę i wyścig
+            entries.erase(entry->id);
+            running--;
+            finished++;
+            idle.notify_all();
+        }
+    }
+}
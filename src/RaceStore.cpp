@@ -0,0 +1,447 @@
+#include "../include/RaceStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+// Układ pliku:
+//   nagłówek: magic[8], wersja u32, okrążenia varint, kierowcy varint, nazwy (długość varint + bajty)
+//   bloki (kolumny: ziarna, zwycięzcy, pola startowe, kolejność, czasy, pozycje na okrążeniach, zjazdy):
+//          magic u32, wyścigi varint, kolumny varint, rozmiary kolumn varint,
+//          zbiór zwycięzców bloku (bity, ceil(kierowcy / 8) B), dane kolumn
+constexpr char STORE_MAGIC[8] = {'F', '1', 'R', 'A', 'C', 'E', 'S', '\0'};
+constexpr uint32_t STORE_VERSION = 1;
+constexpr uint32_t BLOCK_MAGIC = 0x4B423146; // "F1BK"
+
+enum ColumnIndex {
+    SEED_COLUMN,
+    WINNER_COLUMN,
+    GRID_COLUMN,
+    ORDER_COLUMN,
+    FINISH_TIMES_COLUMN,
+    LAP_POSITIONS_COLUMN,
+    PIT_LAPS_COLUMN,
+    COLUMN_COUNT
+};
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Token serii zer i niezerowej wartości: krótka seria i mała wartość w jednym bajcie
+// (seria << 4 | wartość), w przeciwnym razie bajt 0 i dwa varinty
+void putRunToken(std::vector<uint8_t>& out, uint64_t zeros, uint64_t value) {
+    if (zeros < 16 && value > 0 && value < 16) {
+        out.push_back(static_cast<uint8_t>(zeros << 4 | value));
+    } else {
+        out.push_back(0);
+        putVarint(out, zeros);
+        putVarint(out, value);
+    }
+}
+
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    void runToken(uint64_t& zeros, uint64_t& value) {
+        uint8_t token = (p < end) ? *p++ : 0;
+        if (token & 0x0F) {
+            zeros = token >> 4;
+            value = token & 0x0F;
+        } else {
+            zeros = varint();
+            value = varint();
+        }
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        int shift = 0;
+        while (p < end) {
+            uint8_t b = *p++;
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        return v;
+    }
+};
+
+bool readVarint(std::ifstream& in, uint64_t& v) {
+    v = 0;
+    int shift = 0;
+    for (int i = 0; i < 10; ++i) {
+        int c = in.get();
+        if (c == EOF) return false;
+        v |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+        shift += 7;
+    }
+    return false;
+}
+
+}
+
+RaceStoreWriter::~RaceStoreWriter() {
+    close();
+}
+
+bool RaceStoreWriter::open(const std::string& filepath, const std::vector<std::string>& d, int l, int b) {
+    file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error creating race store: " << filepath << std::endl;
+        return false;
+    }
+
+    drivers = d;
+    laps = l;
+    blockSize = std::max(1, b);
+
+    std::vector<uint8_t> header(STORE_MAGIC, STORE_MAGIC + sizeof(STORE_MAGIC));
+    uint32_t version = STORE_VERSION;
+    header.insert(header.end(), reinterpret_cast<uint8_t*>(&version), reinterpret_cast<uint8_t*>(&version) + 4);
+    putVarint(header, laps);
+    putVarint(header, drivers.size());
+    for (const auto& name : drivers) {
+        putVarint(header, name.size());
+        header.insert(header.end(), name.begin(), name.end());
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    columns.assign(COLUMN_COUNT, {});
+    resetBlock();
+    return file.good();
+}
+
+void RaceStoreWriter::resetBlock() {
+    for (auto& c : columns) c.clear();
+    winnerSet.assign((drivers.size() + 7) / 8, 0);
+    blockRaces = 0;
+    prevSeed = 0;
+    prevWinnerTime = 0;
+    prevGrid.assign(drivers.size(), 0);
+    prevOrder.assign(drivers.size(), 0);
+}
+
+bool RaceStoreWriter::append(const RaceResult& result) {
+    if (!file.is_open()) return false;
+
+    size_t n = drivers.size();
+    if (result.classification.size() != n) {
+        std::cerr << "Race store expects " << n << " cars, got " << result.classification.size() << std::endl;
+        return false;
+    }
+
+    std::vector<int> order(n), grid(n);
+    std::vector<const CarResult*> byDriver(n, nullptr);
+    for (size_t p = 0; p < n; ++p) {
+        const CarResult& c = result.classification[p];
+        auto it = std::find(drivers.begin(), drivers.end(), c.driverName);
+        if (it == drivers.end() || byDriver[it - drivers.begin()]) {
+            std::cerr << "Unknown or duplicate driver in race store: " << c.driverName << std::endl;
+            return false;
+        }
+        int d = it - drivers.begin();
+        order[p] = d;
+        grid[d] = c.gridPosition;
+        byDriver[d] = &c;
+    }
+
+    putVarint(columns[SEED_COLUMN], zigzag(static_cast<int64_t>(result.seed) - prevSeed));
+    prevSeed = result.seed;
+
+    putVarint(columns[WINNER_COLUMN], order[0]);
+    winnerSet[order[0] / 8] |= static_cast<uint8_t>(1u << (order[0] % 8));
+
+    for (size_t d = 0; d < n; ++d) {
+        putVarint(columns[GRID_COLUMN], zigzag(grid[d] - prevGrid[d]));
+        putVarint(columns[ORDER_COLUMN], zigzag(order[d] - prevOrder[d]));
+    }
+    prevGrid = grid;
+    prevOrder = order;
+
+    int64_t prevMs = 0;
+    for (size_t p = 0; p < n; ++p) {
+        int64_t ms = std::llround(result.classification[p].finishTime * 1000.0);
+        if (p == 0) {
+            putVarint(columns[FINISH_TIMES_COLUMN], zigzag(ms - prevWinnerTime));
+            prevWinnerTime = ms;
+        } else {
+            putVarint(columns[FINISH_TIMES_COLUMN], std::max<int64_t>(0, ms - prevMs));
+        }
+        prevMs = std::max(prevMs, ms);
+    }
+
+    // Pozycje na koniec każdego okrążenia z sumy czasów okrążeń; zmiana względem
+    // poprzedniego okrążenia, serie zer zapisane jako długość serii
+    std::vector<double> elapsed(n, 0.0);
+    std::vector<int> prevPos = grid, rank(n), pos(n);
+    uint64_t zeros = 0;
+    std::vector<uint8_t>& lapColumn = columns[LAP_POSITIONS_COLUMN];
+    for (int lap = 0; lap < laps; ++lap) {
+        for (size_t d = 0; d < n; ++d) {
+            const auto& lapTimes = byDriver[d]->lapTimes;
+            elapsed[d] += (lap < static_cast<int>(lapTimes.size())) ? lapTimes[lap] : 0.0;
+        }
+        std::iota(rank.begin(), rank.end(), 0);
+        std::sort(rank.begin(), rank.end(), [&](int a, int b) {
+            if (elapsed[a] != elapsed[b]) return elapsed[a] < elapsed[b];
+            return grid[a] < grid[b];
+        });
+        for (size_t p = 0; p < n; ++p) pos[rank[p]] = p + 1;
+
+        for (size_t d = 0; d < n; ++d) {
+            uint64_t v = zigzag(pos[d] - prevPos[d]);
+            if (v == 0) {
+                zeros++;
+            } else {
+                putRunToken(lapColumn, zeros, v);
+                zeros = 0;
+            }
+        }
+        prevPos = pos;
+    }
+    if (zeros > 0) putRunToken(lapColumn, zeros, 0);
+
+    for (size_t d = 0; d < n; ++d) {
+        const auto& pits = byDriver[d]->pitLaps;
+        putVarint(columns[PIT_LAPS_COLUMN], pits.size());
+        int prevLap = 0;
+        for (int lap : pits) {
+            putVarint(columns[PIT_LAPS_COLUMN], lap - prevLap);
+            prevLap = lap;
+        }
+    }
+
+    blockRaces++;
+    if (blockRaces >= blockSize) return flushBlock();
+    return true;
+}
+
+bool RaceStoreWriter::flushBlock() {
+    if (blockRaces == 0) return true;
+
+    std::vector<uint8_t> header;
+    uint32_t magic = BLOCK_MAGIC;
+    header.insert(header.end(), reinterpret_cast<uint8_t*>(&magic), reinterpret_cast<uint8_t*>(&magic) + 4);
+    putVarint(header, blockRaces);
+    putVarint(header, COLUMN_COUNT);
+    for (const auto& c : columns) putVarint(header, c.size());
+    header.insert(header.end(), winnerSet.begin(), winnerSet.end());
+
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    for (const auto& c : columns) {
+        file.write(reinterpret_cast<const char*>(c.data()), c.size());
+    }
+
+    resetBlock();
+    return file.good();
+}
+
+bool RaceStoreWriter::close() {
+    if (!file.is_open()) return true;
+    bool ok = flushBlock();
+    file.close();
+    return ok;
+}
+
+bool RaceStoreReader::open(const std::string& filepath) {
+    file.open(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening race store: " << filepath << std::endl;
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff end = file.tellg();
+    file.seekg(0);
+    if (end < 0) {
+        std::cerr << "Error opening race store: " << filepath << std::endl;
+        return false;
+    }
+    uint64_t fileSize = static_cast<uint64_t>(end);
+
+    char magic[8];
+    uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), 4);
+    if (!file || std::memcmp(magic, STORE_MAGIC, sizeof(magic)) != 0 || version != STORE_VERSION) {
+        std::cerr << "Not a race store: " << filepath << std::endl;
+        return false;
+    }
+
+    uint64_t v = 0, count = 0;
+    if (!readVarint(file, v)) return false;
+    laps = v;
+    if (!readVarint(file, count)) return false;
+    drivers.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!readVarint(file, v) || v > fileSize) return false;
+        std::string name(v, '\0');
+        if (!file.read(name.data(), v)) return false;
+        drivers.push_back(name);
+    }
+
+    // Indeks bloków: tylko nagłówki, dane kolumn są pomijane
+    blocks.clear();
+    totalRaces = 0;
+    while (true) {
+        uint32_t blockMagic = 0;
+        if (!file.read(reinterpret_cast<char*>(&blockMagic), 4) && file.gcount() == 0) break;
+        if (!file || blockMagic != BLOCK_MAGIC) {
+            std::cerr << "Corrupted race store block: " << filepath << std::endl;
+            return false;
+        }
+
+        Block block;
+        uint64_t races = 0, columnCount = 0;
+        if (!readVarint(file, races) || !readVarint(file, columnCount) || columnCount < COLUMN_COUNT) return false;
+        block.races = races;
+        for (uint64_t c = 0; c < columnCount; ++c) {
+            if (!readVarint(file, v)) return false;
+            block.columnSizes.push_back(v);
+        }
+        block.winnerSet.resize((drivers.size() + 7) / 8);
+        file.read(reinterpret_cast<char*>(block.winnerSet.data()), block.winnerSet.size());
+        std::streamoff start = file ? static_cast<std::streamoff>(file.tellg()) : -1;
+        if (start < 0) {
+            std::cerr << "Truncated race store block: " << filepath << std::endl;
+            return false;
+        }
+
+        // Obcięty plik nie może dać kolumn czytanych poza jego końcem
+        uint64_t offset = start;
+        for (uint64_t size : block.columnSizes) {
+            if (size > fileSize - offset) {
+                std::cerr << "Truncated race store block: " << filepath << std::endl;
+                return false;
+            }
+            block.columnOffsets.push_back(offset);
+            offset += size;
+        }
+        file.seekg(offset);
+
+        totalRaces += block.races;
+        blocks.push_back(block);
+    }
+    file.clear();
+    return true;
+}
+
+int RaceStoreReader::driverIndex(const std::string& name) const {
+    auto it = std::find(drivers.begin(), drivers.end(), name);
+    return (it != drivers.end()) ? static_cast<int>(it - drivers.begin()) : -1;
+}
+
+std::vector<uint8_t> RaceStoreReader::readColumn(const Block& block, int column) {
+    std::vector<uint8_t> bytes(block.columnSizes[column]);
+    file.seekg(block.columnOffsets[column]);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    return bytes;
+}
+
+void RaceStoreReader::scan(unsigned columnMask, const std::function<void(const RaceSummary&)>& visit, int winner) {
+    size_t n = drivers.size();
+    if (columnMask & COLUMN_LAP_POSITIONS) columnMask |= COLUMN_GRID;
+
+    for (const auto& block : blocks) {
+        if (winner >= 0 && !(block.winnerSet[winner / 8] & (1u << (winner % 8)))) continue;
+
+        std::vector<std::vector<uint8_t>> data(COLUMN_COUNT);
+        std::vector<Cursor> cursors(COLUMN_COUNT);
+        for (int c = 0; c < COLUMN_COUNT; ++c) {
+            // Zwycięzca jest zawsze dekodowany - służy do filtrowania
+            if (c == WINNER_COLUMN || (columnMask & (1u << c))) {
+                data[c] = readColumn(block, c);
+                cursors[c] = Cursor{data[c].data(), data[c].data() + data[c].size()};
+            }
+        }
+
+        RaceSummary s;
+        int64_t seed = 0, winnerTime = 0;
+        std::vector<int> prevGrid(n, 0), prevOrder(n, 0);
+
+        for (int r = 0; r < block.races; ++r) {
+            s.winner = cursors[WINNER_COLUMN].varint();
+
+            if (columnMask & COLUMN_SEED) {
+                seed += unzigzag(cursors[SEED_COLUMN].varint());
+                s.seed = seed;
+            }
+            if (columnMask & COLUMN_GRID) {
+                s.grid.resize(n);
+                for (size_t d = 0; d < n; ++d) s.grid[d] = prevGrid[d] += unzigzag(cursors[GRID_COLUMN].varint());
+            }
+            if (columnMask & COLUMN_ORDER) {
+                s.order.resize(n);
+                for (size_t p = 0; p < n; ++p) s.order[p] = prevOrder[p] += unzigzag(cursors[ORDER_COLUMN].varint());
+            }
+            if (columnMask & COLUMN_FINISH_TIMES) {
+                s.finishTimes.resize(n);
+                winnerTime += unzigzag(cursors[FINISH_TIMES_COLUMN].varint());
+                int64_t ms = winnerTime;
+                s.finishTimes[0] = ms / 1000.0;
+                for (size_t p = 1; p < n; ++p) {
+                    ms += cursors[FINISH_TIMES_COLUMN].varint();
+                    s.finishTimes[p] = ms / 1000.0;
+                }
+            }
+            if (columnMask & COLUMN_LAP_POSITIONS) {
+                size_t total = static_cast<size_t>(laps) * n;
+                s.lapPositions.assign(total, 0);
+                size_t filled = 0;
+                while (filled < total) {
+                    uint64_t zeros = 0, value = 0;
+                    cursors[LAP_POSITIONS_COLUMN].runToken(zeros, value);
+                    for (size_t k = 0; k < zeros && filled < total; ++k, ++filled) {
+                        size_t d = filled % n;
+                        s.lapPositions[filled] = (filled < n) ? s.grid[d] : s.lapPositions[filled - n];
+                    }
+                    if (filled >= total) break;
+                    size_t d = filled % n;
+                    int prev = (filled < n) ? s.grid[d] : s.lapPositions[filled - n];
+                    s.lapPositions[filled++] = prev + unzigzag(value);
+                }
+            }
+            if (columnMask & COLUMN_PIT_LAPS) {
+                s.pitLaps.assign(n, {});
+                for (size_t d = 0; d < n; ++d) {
+                    uint64_t count = cursors[PIT_LAPS_COLUMN].varint();
+                    int lap = 0;
+                    for (uint64_t k = 0; k < count; ++k) {
+                        lap += cursors[PIT_LAPS_COLUMN].varint();
+                        s.pitLaps[d].push_back(lap);
+                    }
+                }
+            }
+
+            if (winner < 0 || s.winner == winner) visit(s);
+        }
+    }
+}
+
+std::vector<uint32_t> RaceStoreReader::findWins(const std::string& driver, int minGrid) {
+    std::vector<uint32_t> seeds;
+    int d = driverIndex(driver);
+    if (d < 0) return seeds;
+
+    scan(COLUMN_SEED | COLUMN_GRID, [&](const RaceSummary& s) {
+        if (s.grid[d] >= minGrid) seeds.push_back(s.seed);
+    }, d);
+    return seeds;
+}
@@ -0,0 +1,47 @@
+#include "../include/RandomBlock.h"
+#include "../include/Hash.h"
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+constexpr uint64_t LAP_DOMAIN = 0xD1B54A32D192ED03ULL;   // oddziela normalne okrążeń od kroków
+
+// 53 najstarsze bity -> [0, 1)
+inline double toUnit(uint64_t x) {
+    return static_cast<double>(x >> 11) * 0x1.0p-53;
+}
+
+}
+
+void RandomBlock::reset(const std::vector<uint64_t>& streamKeys, int raceLaps) {
+    keys = streamKeys;
+    laps = raceLaps > 0 ? raceLaps : 0;
+    uniforms.assign(keys.size() * UNIFORMS_PER_STEP, 0.0);
+    normals.assign(keys.size() * laps, 0.0);
+
+    // Box-Muller: para jednostajnych na okrążenie, raz na wyścig zamiast w pętli kroku
+    for (size_t s = 0; s < keys.size(); ++s) {
+        uint64_t key = keys[s] ^ LAP_DOMAIN;
+        for (int lap = 0; lap < laps; ++lap) {
+            uint64_t counter = 2 * static_cast<uint64_t>(lap);
+            double u1 = 1.0 - toUnit(mix64(key + (counter + 1) * GOLDEN_GAMMA));   // (0, 1]
+            double u2 = toUnit(mix64(key + (counter + 2) * GOLDEN_GAMMA));
+            normals[s * laps + lap] = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * std::numbers::pi * u2);
+        }
+    }
+}
+
+void RandomBlock::fillStep(uint64_t step) {
+    // Bez rozgałęzień i bez stanu przenoszonego między iteracjami
+    size_t count = keys.size();
+    const uint64_t* k = keys.data();
+    double* out = uniforms.data();
+    uint64_t counter = step * UNIFORMS_PER_STEP;
+    for (size_t s = 0; s < count; ++s) {
+        for (int slot = 0; slot < UNIFORMS_PER_STEP; ++slot) {
+            out[s * UNIFORMS_PER_STEP + slot] = toUnit(mix64(k[s] + (counter + slot + 1) * GOLDEN_GAMMA));
+        }
+    }
+}
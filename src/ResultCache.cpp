@@ -0,0 +1,289 @@
+#include "../include/ResultCache.h"
+#include "../include/Hash.h"
+#include "../include/MonteCarlo.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Układ wpisu: magic[4], wersja u32, klucz (32 B), ziarno u32, bolidy u32,
+// dla każdego bolidu: kierowca, zespół (długość u32 + bajty), pole i pozycja i32,
+// czas f64, czasy okrążeń (liczba u32 + f64), zjazdy (liczba u32 + i32)
+constexpr char ENTRY_MAGIC[4] = {'F', '1', 'R', 'C'};
+constexpr uint32_t ENTRY_VERSION = 1;
+constexpr const char* ENTRY_EXTENSION = ".f1res";
+
+// Bajty kanoniczne scenariusza - wartości po wczytaniu konfiguracji, nie tekst plików
+class KeyBuilder {
+public:
+    template <typename T>
+    void add(const T& value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+    }
+
+    void add(const std::string& text) {
+        add(static_cast<uint32_t>(text.size()));
+        bytes.insert(bytes.end(), text.begin(), text.end());
+    }
+
+    std::string hex() const {
+        // Dwa niezależne skróty 64-bitowe - praktycznie bez kolizji
+        uint64_t h1 = fnv1a(bytes.data(), bytes.size());
+        uint64_t h2 = mix64(fnv1a(bytes.data(), bytes.size(), mix64(FNV_OFFSET_BASIS)));
+        char out[33];
+        std::snprintf(out, sizeof(out), "%016llx%016llx", static_cast<unsigned long long>(h1),
+                      static_cast<unsigned long long>(h2));
+        return out;
+    }
+
+private:
+    std::vector<char> bytes;
+};
+
+template <typename T>
+void write(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write(std::ofstream& out, const std::string& text) {
+    write(out, static_cast<uint32_t>(text.size()));
+    out.write(text.data(), text.size());
+}
+
+template <typename T>
+bool read(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool read(std::ifstream& in, std::string& text) {
+    uint32_t size = 0;
+    if (!read(in, size) || size > 4096) return false;
+    text.resize(size);
+    return static_cast<bool>(in.read(text.data(), size));
+}
+
+}
+
+ResultCache::ResultCache(const std::string& dir, uint64_t limit) : directory(dir), maxBytes(limit) {}
+
+bool ResultCache::open() {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "Cannot create cache directory " << directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    totalBytes = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ENTRY_EXTENSION) totalBytes += entry.file_size();
+    }
+    return true;
+}
+
+std::string ResultCache::scenarioKey(const RaceSetup& setup) {
+    KeyBuilder key;
+    key.add(static_cast<int32_t>(SIMULATOR_VERSION));
+
+    key.add(static_cast<uint32_t>(setup.drivers.size()));
+    for (const auto& d : setup.drivers) {
+        key.add(d.name);
+        key.add(d.teamName);
+        key.add(static_cast<int32_t>(d.exp));
+        key.add(static_cast<int32_t>(d.racecraft));
+        key.add(static_cast<int32_t>(d.awareness));
+        key.add(static_cast<int32_t>(d.pace));
+    }
+
+    key.add(static_cast<uint32_t>(setup.teams.size()));
+    for (const auto& t : setup.teams) {
+        key.add(t.name);
+        key.add(t.topSpeed);
+        key.add(t.acceleration);
+        key.add(t.braking);
+        key.add(t.baseTireGrip);
+        key.add(t.pitStopMultiplier);
+    }
+
+    key.add(setup.track.totalLength);
+    key.add(static_cast<uint32_t>(setup.track.segments.size()));
+    for (const auto& seg : setup.track.segments) {
+        key.add(seg.type);
+        key.add(seg.length);
+        key.add(seg.angle);
+        key.add(seg.radius);
+    }
+
+    key.add(static_cast<int32_t>(setup.laps));
+    key.add(static_cast<int32_t>(setup.weather));
+    return key.hex();
+}
+
+std::string ResultCache::entryPath(const std::string& key, unsigned int seed) const {
+    return directory + "/" + key + "/" + std::to_string(seed) + ENTRY_EXTENSION;
+}
+
+bool ResultCache::load(const std::string& key, unsigned int seed, RaceResult& result) {
+    std::string path = entryPath(key, seed);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t version = 0, storedSeed = 0, cars = 0;
+    char storedKey[32];
+    bool ok = static_cast<bool>(in.read(magic, 4)) && read(in, version)
+           && in.read(storedKey, 32) && read(in, storedSeed) && read(in, cars)
+           && std::memcmp(magic, ENTRY_MAGIC, 4) == 0 && version == ENTRY_VERSION
+           && key.compare(0, 32, storedKey, 32) == 0 && storedSeed == seed && cars <= 1024;
+
+    result.seed = seed;
+    result.classification.assign(ok ? cars : 0, CarResult{});
+    for (auto& c : result.classification) {
+        uint32_t laps = 0, pits = 0;
+        int32_t grid = 0, finish = 0;
+        ok = ok && read(in, c.driverName) && read(in, c.teamName) && read(in, grid) && read(in, finish)
+                && read(in, c.finishTime) && read(in, laps) && laps <= 100000;
+        if (!ok) break;
+        c.gridPosition = grid;
+        c.finishPosition = finish;
+        c.lapTimes.resize(laps);
+        ok = static_cast<bool>(in.read(reinterpret_cast<char*>(c.lapTimes.data()), laps * sizeof(double)))
+          && read(in, pits) && pits <= 100000;
+        if (!ok) break;
+        c.pitLaps.resize(pits);
+        for (auto& lap : c.pitLaps) {
+            int32_t value = 0;
+            ok = ok && read(in, value);
+            lap = value;
+        }
+    }
+    in.close();
+
+    std::error_code ec;
+    if (!ok) {
+        // Uszkodzony lub obcy wpis - usuń i policz ponownie
+        std::cerr << "Discarding invalid cache entry " << path << std::endl;
+        uint64_t size = fs::file_size(path, ec);
+        if (!ec && fs::remove(path, ec)) totalBytes -= std::min(totalBytes, size);
+        return false;
+    }
+
+    // Odświeżenie czasu modyfikacji - kolejność usuwania LRU
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool ResultCache::store(const std::string& key, const RaceResult& result) {
+    std::error_code ec;
+    fs::create_directories(directory + "/" + key, ec);
+
+    std::string path = entryPath(key, result.seed);
+    // Własny plik tymczasowy - kilka procesów może jednocześnie liczyć to samo ziarno
+    char suffix[40];
+    std::snprintf(suffix, sizeof(suffix), ".%08x%016zx.tmp", std::random_device{}(),
+                  std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::string tmpPath = path + suffix;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Cannot write cache entry " << tmpPath << std::endl;
+            return false;
+        }
+        out.write(ENTRY_MAGIC, 4);
+        write(out, ENTRY_VERSION);
+        out.write(key.data(), 32);
+        write(out, static_cast<uint32_t>(result.seed));
+        write(out, static_cast<uint32_t>(result.classification.size()));
+        for (const auto& c : result.classification) {
+            write(out, c.driverName);
+            write(out, c.teamName);
+            write(out, static_cast<int32_t>(c.gridPosition));
+            write(out, static_cast<int32_t>(c.finishPosition));
+            write(out, c.finishTime);
+            write(out, static_cast<uint32_t>(c.lapTimes.size()));
+            out.write(reinterpret_cast<const char*>(c.lapTimes.data()), c.lapTimes.size() * sizeof(double));
+            write(out, static_cast<uint32_t>(c.pitLaps.size()));
+            for (int lap : c.pitLaps) write(out, static_cast<int32_t>(lap));
+        }
+        if (!out) {
+            std::cerr << "Cannot write cache entry " << tmpPath << std::endl;
+            out.close();
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    // Zamiana nazwy jest atomowa - czytelnik nigdy nie widzi niepełnego wpisu
+    uint64_t previous = fs::exists(path, ec) ? fs::file_size(path, ec) : 0;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        // Inny proces zdążył zapisać ten sam wpis - poprawny wpis to sukces
+        fs::remove(tmpPath, ec);
+        RaceResult existing;
+        if (load(key, result.seed, existing)) return true;
+        std::cerr << "Cannot write cache entry " << path << std::endl;
+        return false;
+    }
+    totalBytes = totalBytes - std::min(previous, totalBytes) + fs::file_size(path, ec);
+
+    if (totalBytes > maxBytes) evict();
+    return true;
+}
+
+void ResultCache::evict() {
+    struct Entry {
+        fs::file_time_type used;
+        fs::path path;
+        uint64_t size;
+    };
+
+    std::vector<Entry> entries;
+    std::error_code ec;
+    totalBytes = 0;
+    for (const auto& e : fs::recursive_directory_iterator(directory, ec)) {
+        if (!e.is_regular_file() || e.path().extension() != ENTRY_EXTENSION) continue;
+        entries.push_back({e.last_write_time(), e.path(), e.file_size()});
+        totalBytes += entries.back().size;
+    }
+
+    // Usuwanie do 90% limitu, żeby nie skanować katalogu przy każdym zapisie
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    uint64_t target = maxBytes / 10 * 9;
+    for (const auto& e : entries) {
+        if (totalBytes <= target) break;
+        if (fs::remove(e.path, ec)) {
+            totalBytes -= std::min(totalBytes, e.size);
+            stats.evicted++;
+            fs::path scenarioDir = e.path.parent_path();
+            if (fs::is_empty(scenarioDir, ec)) fs::remove(scenarioDir, ec);
+        }
+    }
+}
+
+std::vector<RaceResult> ResultCache::run(const RaceSetup& setup, unsigned int firstSeed, int count, int threads) {
+    std::string key = scenarioKey(setup);
+    std::vector<RaceResult> results(std::max(count, 0));
+
+    std::vector<int> missing;
+    for (int r = 0; r < count; ++r) {
+        if (load(key, firstSeed + r, results[r])) stats.hits++;
+        else missing.push_back(r);
+    }
+    stats.misses += missing.size();
+
+    parallelFor(static_cast<int>(missing.size()), threads, [&](int i) {
+        results[missing[i]] = simulateRace(setup, firstSeed + missing[i]);
+    });
+
+    for (int r : missing) store(key, results[r]);
+    return results;
+}
@@ -0,0 +1,202 @@
+#include "../include/Sensitivity.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+double* teamParameter(Team& team, SensitivityParameter parameter) {
+    switch (parameter) {
+        case SensitivityParameter::TopSpeed: return &team.topSpeed;
+        case SensitivityParameter::Acceleration: return &team.acceleration;
+        case SensitivityParameter::Braking: return &team.braking;
+        case SensitivityParameter::BaseTireGrip: return &team.baseTireGrip;
+        default: return nullptr;
+    }
+}
+
+bool applyPerturbation(RaceSetup& setup, const Perturbation& p, double sign) {
+    if (p.parameter == SensitivityParameter::DriverPace) {
+        for (auto& d : setup.drivers) {
+            if (d.name == p.target) {
+                d.pace += static_cast<int>(std::lround(sign * p.step));
+                return true;
+            }
+        }
+        return false;
+    }
+    for (auto& t : setup.teams) {
+        if (t.name == p.target) {
+            *teamParameter(t, p.parameter) += sign * p.step;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+bool parseSensitivityParameter(const std::string& name, SensitivityParameter& parameter) {
+    if (name == "topSpeed") parameter = SensitivityParameter::TopSpeed;
+    else if (name == "acceleration") parameter = SensitivityParameter::Acceleration;
+    else if (name == "braking") parameter = SensitivityParameter::Braking;
+    else if (name == "baseTireGrip") parameter = SensitivityParameter::BaseTireGrip;
+    else if (name == "pace") parameter = SensitivityParameter::DriverPace;
+    else return false;
+    return true;
+}
+
+std::string sensitivityParameterName(SensitivityParameter parameter) {
+    switch (parameter) {
+        case SensitivityParameter::TopSpeed: return "topSpeed";
+        case SensitivityParameter::Acceleration: return "acceleration";
+        case SensitivityParameter::Braking: return "braking";
+        case SensitivityParameter::BaseTireGrip: return "baseTireGrip";
+        case SensitivityParameter::DriverPace: return "pace";
+    }
+    return "unknown";
+}
+
+std::vector<Perturbation> buildPerturbations(const RaceSetup& setup, const std::vector<SensitivityParameter>& parameters,
+                                             double relativeStep, const std::string& target) {
+    std::vector<Perturbation> result;
+
+    for (const auto& team : setup.teams) {
+        bool selected = target.empty() || target == team.name;
+        for (const auto& d : setup.drivers) {
+            if (d.name == target && d.teamName == team.name) selected = true;
+        }
+        if (!selected) continue;
+
+        Team copy = team;
+        for (auto parameter : parameters) {
+            double* value = teamParameter(copy, parameter);
+            if (!value) continue;
+            double step = std::abs(*value) * relativeStep;
+            if (step > 0) result.push_back({parameter, team.name, step});
+        }
+    }
+
+    bool pace = std::find(parameters.begin(), parameters.end(), SensitivityParameter::DriverPace) != parameters.end();
+    for (const auto& d : setup.drivers) {
+        if (!pace || !(target.empty() || target == d.name || target == d.teamName)) continue;
+        // pace jest całkowity - krok co najmniej o 1 punkt
+        double step = std::max(1.0, std::round(d.pace * relativeStep));
+        result.push_back({SensitivityParameter::DriverPace, d.name, step});
+    }
+    return result;
+}
+
+SensitivityAnalyzer::SensitivityAnalyzer(const RaceSetup& s, const SensitivityOptions& o)
+    : setup(s), options(o) {
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (options.batchSize <= 0) options.batchSize = 1;
+    z = twoSidedZ(options.confidence);
+
+    variants.push_back(setup);
+    std::vector<Perturbation> valid;
+    for (const auto& p : options.perturbations) {
+        RaceSetup plus = setup, minus = setup;
+        if (p.step <= 0 || !applyPerturbation(plus, p, 1.0) || !applyPerturbation(minus, p, -1.0)) {
+            std::cerr << "Skipping perturbation of " << sensitivityParameterName(p.parameter)
+                      << " for unknown target: " << p.target << std::endl;
+            continue;
+        }
+        variants.push_back(std::move(plus));
+        variants.push_back(std::move(minus));
+        valid.push_back(p);
+    }
+    options.perturbations = valid;
+
+    // Raportowana jest pozycja kierowców, których dotyczy zmiana
+    for (size_t p = 0; p < valid.size(); ++p) {
+        for (size_t d = 0; d < setup.drivers.size(); ++d) {
+            bool affected = (valid[p].parameter == SensitivityParameter::DriverPace)
+                ? setup.drivers[d].name == valid[p].target
+                : setup.drivers[d].teamName == valid[p].target;
+            if (affected) series.push_back({p, d, {}, {}, {}});
+        }
+    }
+    baseline.resize(setup.drivers.size());
+}
+
+void SensitivityAnalyzer::runBatch(unsigned int firstSeed, int count, std::vector<int>& finishPositions) const {
+    size_t n = setup.drivers.size();
+    int v = static_cast<int>(variants.size());
+    finishPositions.assign(static_cast<size_t>(count) * v * n, 0);
+
+    std::unordered_map<std::string, size_t> driverIndex;
+    for (size_t i = 0; i < n; ++i) driverIndex[setup.drivers[i].name] = i;
+
+    // Zadanie = (ziarno, wariant); wszystkie warianty jednego ziarna dzielą strumienie losowe
+    parallelFor(count * v, options.threads, [&](int j) {
+        RaceResult result = simulateRace(variants[j % v], firstSeed + j / v);
+        for (const auto& c : result.classification) {
+            finishPositions[static_cast<size_t>(j) * n + driverIndex.at(c.driverName)] = c.finishPosition;
+        }
+    });
+}
+
+SensitivityReport SensitivityAnalyzer::run() {
+    size_t n = setup.drivers.size();
+    size_t v = variants.size();
+    std::vector<int> finishPositions;
+    if (series.empty()) return buildReport(0, 0.0);
+
+    SamplingLimits limits{options.batchSize, options.minRaces, options.maxRaces, options.timeBudgetSeconds, options.firstSeed};
+    double seconds = 0.0;
+    int races = sampleBatches(limits, [&](unsigned int firstSeed, int count) {
+        runBatch(firstSeed, count, finishPositions);
+
+        // Scalanie w kolejności ziaren - wynik nie zależy od liczby wątków
+        for (int r = 0; r < count; ++r) {
+            const int* positions = &finishPositions[r * v * n];
+            for (size_t d = 0; d < n; ++d) baseline[d].add(positions[d]);
+
+            for (auto& s : series) {
+                double plus = positions[(1 + 2 * s.perturbation) * n + s.driver];
+                double minus = positions[(2 + 2 * s.perturbation) * n + s.driver];
+                s.slope.add((plus - minus) / (2.0 * options.perturbations[s.perturbation].step));
+                s.plus.add(plus);
+                s.minus.add(minus);
+            }
+        }
+    }, [&](int done, double elapsed) { return buildReport(done, elapsed).converged; }, seconds);
+
+    return buildReport(races, seconds);
+}
+
+SensitivityReport SensitivityAnalyzer::buildReport(int races, double seconds) const {
+    SensitivityReport report;
+    report.races = races;
+    report.simulations = races * static_cast<int>(variants.size());
+    report.seconds = seconds;
+    report.converged = races > 1;
+
+    for (const auto& s : series) {
+        const Perturbation& p = options.perturbations[s.perturbation];
+        SensitivityEstimate e;
+        e.perturbation = p;
+        e.driverName = setup.drivers[s.driver].name;
+        e.baselinePosition = baseline[s.driver].mean;
+
+        double halfWidth = (s.slope.n > 1) ? z * std::sqrt(s.slope.variance() / s.slope.n)
+                                           : static_cast<double>(setup.drivers.size()) / p.step;
+        e.slope = {s.slope.mean, halfWidth};
+
+        // Wariancja tego samego estymatora przy niezależnych wyścigach +krok i -krok
+        double independent = (s.plus.variance() + s.minus.variance()) / (4.0 * p.step * p.step);
+        e.varianceReduction = (s.slope.variance() > 0) ? independent / s.slope.variance() : 0.0;
+
+        if (halfWidth * p.step > options.precision) report.converged = false;
+        report.estimates.push_back(e);
+    }
+
+    // Największy wpływ na krok zaburzenia na początku
+    std::stable_sort(report.estimates.begin(), report.estimates.end(), [](const SensitivityEstimate& a, const SensitivityEstimate& b) {
+        return std::abs(a.slope.value * a.perturbation.step) > std::abs(b.slope.value * b.perturbation.step);
+    });
+    return report;
+}
@@ -0,0 +1,90 @@
+#include "../include/Simulation.h"
+#include "../include/Race.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+double qualifyingBaseLapTime(const Track& track) {
+    double baseLapTime = 0.0;
+    
+    for (const auto& seg : track.segments) {
+        double segmentSpeed = 0;
+        
+        if (seg.type == "STRAIGHT") {
+            if (seg.length > 500) segmentSpeed = 75.0;
+            else segmentSpeed = 55.0;
+        } else {
+            double absRadius = std::abs(seg.radius);
+            if (absRadius < 1.0) absRadius = 1.0;
+
+            double cornerGrip = 2.5;
+            double vMax = std::sqrt(absRadius * 9.81 * cornerGrip);
+            
+            if (vMax > 85.0) vMax = 85.0; 
+            segmentSpeed = vMax;
+        }
+        
+        if (segmentSpeed < 1.0) segmentSpeed = 1.0;
+        baseLapTime += (seg.length / segmentSpeed);
+    }
+    
+    return baseLapTime * 1.10; 
+}
+
+double qualifyingTimeMultiplier(const Driver& driver, const Team& car) {
+    double carScore = (car.topSpeed / 100.0) * 0.4 + (car.acceleration / 15.0) * 0.3 + (car.baseTireGrip / 2.5) * 0.3;
+    double driverScore = (driver.pace / 100.0) * 0.7 + (driver.racecraft / 100.0) * 0.3;
+    double totalPerformance = (carScore * 0.65 + driverScore * 0.35);
+    return 1.45 - (totalPerformance * 0.6); 
+}
+
+std::vector<GridPosition> simulateQualifying(const std::vector<Driver>& drivers, const std::vector<Team>& teams, const Track& track, std::mt19937& gen) {
+    std::vector<GridPosition> grid;
+    std::normal_distribution<> d(0, QUALIFYING_TIME_SIGMA);
+
+    std::map<std::string, Team> teamMap;
+    for (const auto& t : teams) teamMap[t.name] = t;
+
+    double baseLapTime = qualifyingBaseLapTime(track);
+
+    for (const auto& driver : drivers) {
+        Team car = teamMap[driver.teamName];
+        double simulatedTime = baseLapTime * qualifyingTimeMultiplier(driver, car) + d(gen);
+
+        GridPosition pos;
+        pos.driver = driver;
+        pos.team = car;
+        pos.qualifyingTime = simulatedTime;
+        grid.push_back(pos);
+    }
+
+    std::sort(grid.begin(), grid.end(), [](const GridPosition& a, const GridPosition& b) {
+        return a.qualifyingTime < b.qualifyingTime;
+    });
+
+    for (size_t i = 0; i < grid.size(); ++i) {
+        grid[i].position = i + 1;
+    }
+
+    return grid;
+}
+
+std::vector<Car> buildStartingGrid(const std::vector<GridPosition>& grid) {
+    std::vector<Car> raceCars;
+    raceCars.reserve(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) {
+        raceCars.emplace_back(grid[i].driver, grid[i].team, i);
+    }
+    return raceCars;
+}
+
+RaceResult simulateRace(const RaceSetup& setup, unsigned int seed) {
+    std::mt19937 gen(seed);
+    auto grid = simulateQualifying(setup.drivers, setup.teams, setup.track, gen);
+
+    Race race(buildStartingGrid(grid), setup.track, setup.laps, setup.weather, gen());
+    race.setThreadCount(setup.stepThreads);
+    RaceResult result = race.simulate();
+    result.seed = seed;
+    return result;
+}
@@ -0,0 +1,264 @@
+#include "../include/TrackLibrary.h"
+#include "../include/Hash.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Układ pliku (little-endian):
+//   nagłówek 32 B: magic[8], wersja u32, liczba torów u32, offset indeksu u64, zarezerwowane u64
+//   indeks 96 B/tor, posortowany po nazwie: nazwa[64], długość f64, segmenty u32, zarezerwowane u32,
+//                                           suma kontrolna u64, offset segmentów u64
+//   segment 32 B: typ u32, zarezerwowane u32, długość f64, kąt f64, promień f64
+constexpr char LIBRARY_MAGIC[8] = {'F', '1', 'T', 'R', 'K', 'L', 'I', 'B'};
+constexpr uint32_t LIBRARY_VERSION = 1;
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t NAME_SIZE = 64;
+constexpr size_t ENTRY_SIZE = 96;
+constexpr size_t SEGMENT_SIZE = 32;
+
+constexpr uint32_t SEGMENT_STRAIGHT = 0;
+constexpr uint32_t SEGMENT_CORNER = 1;
+
+template <typename T>
+void put(std::vector<unsigned char>& out, size_t offset, T value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T get(const unsigned char* data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+}
+
+TrackLibrary::~TrackLibrary() {
+    close();
+}
+
+bool TrackLibrary::build(const std::vector<Track>& tracks, const std::string& filepath) {
+    std::vector<const Track*> sorted;
+    for (const auto& t : tracks) sorted.push_back(&t);
+    std::sort(sorted.begin(), sorted.end(), [](const Track* a, const Track* b) {
+        return a->name < b->name;
+    });
+
+    size_t totalSegments = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (sorted[i]->name.empty() || sorted[i]->name.size() >= NAME_SIZE) {
+            std::cerr << "Invalid track name for library: " << sorted[i]->name << std::endl;
+            return false;
+        }
+        if (i > 0 && sorted[i]->name == sorted[i - 1]->name) {
+            std::cerr << "Duplicate track name in library: " << sorted[i]->name << std::endl;
+            return false;
+        }
+        if (sorted[i]->segments.empty()) {
+            std::cerr << "Track without segments cannot be packed: " << sorted[i]->name << std::endl;
+            return false;
+        }
+        totalSegments += sorted[i]->segments.size();
+    }
+
+    size_t indexOffset = HEADER_SIZE;
+    size_t segmentsOffset = indexOffset + sorted.size() * ENTRY_SIZE;
+    std::vector<unsigned char> out(segmentsOffset + totalSegments * SEGMENT_SIZE, 0);
+
+    std::memcpy(out.data(), LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC));
+    put<uint32_t>(out, 8, LIBRARY_VERSION);
+    put<uint32_t>(out, 12, sorted.size());
+    put<uint64_t>(out, 16, indexOffset);
+
+    size_t cursor = segmentsOffset;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const Track& t = *sorted[i];
+        size_t start = cursor;
+
+        for (const auto& seg : t.segments) {
+            put<uint32_t>(out, cursor, seg.type == "CORNER" ? SEGMENT_CORNER : SEGMENT_STRAIGHT);
+            put<double>(out, cursor + 8, seg.length);
+            put<double>(out, cursor + 16, seg.angle);
+            put<double>(out, cursor + 24, seg.radius);
+            cursor += SEGMENT_SIZE;
+        }
+
+        size_t entry = indexOffset + i * ENTRY_SIZE;
+        std::memcpy(out.data() + entry, t.name.data(), t.name.size());
+        put<double>(out, entry + 64, t.totalLength);
+        put<uint32_t>(out, entry + 72, t.segments.size());
+        put<uint64_t>(out, entry + 80, fnv1a(out.data() + start, cursor - start));
+        put<uint64_t>(out, entry + 88, start);
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error writing track library: " << filepath << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return file.good();
+}
+
+bool TrackLibrary::open(const std::string& filepath) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error opening track library: " << filepath << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "Error mapping track library: " << filepath << std::endl;
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(view);
+    dataSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening track library: " << filepath << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        std::cerr << "Error opening track library: " << filepath << std::endl;
+        return false;
+    }
+    void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        std::cerr << "Error mapping track library: " << filepath << std::endl;
+        return false;
+    }
+    data = static_cast<const unsigned char*>(view);
+    dataSize = st.st_size;
+#endif
+
+    path = filepath;
+
+    if (dataSize < HEADER_SIZE || std::memcmp(data, LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC)) != 0
+        || get<uint32_t>(data, 8) != LIBRARY_VERSION) {
+        std::cerr << "Not a track library: " << filepath << std::endl;
+        close();
+        return false;
+    }
+
+    trackCount = get<uint32_t>(data, 12);
+    uint64_t indexOffset = get<uint64_t>(data, 16);
+    if (indexOffset != HEADER_SIZE || HEADER_SIZE + trackCount * ENTRY_SIZE > dataSize) {
+        std::cerr << "Corrupted track library index: " << filepath << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TrackLibrary::close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(data), dataSize);
+#endif
+    }
+    data = nullptr;
+    dataSize = 0;
+    trackCount = 0;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    compiled.clear();
+}
+
+TrackInfo TrackLibrary::info(size_t index) const {
+    const unsigned char* entry = data + HEADER_SIZE + index * ENTRY_SIZE;
+    const char* name = reinterpret_cast<const char*>(entry);
+
+    // build dopełnia nazwy zerami - wpis bez zera jest uszkodzony i dostaje pustą nazwę
+    size_t length = strnlen(name, NAME_SIZE);
+    TrackInfo i;
+    i.name = std::string_view(name, length < NAME_SIZE ? length : 0);
+    i.totalLength = get<double>(entry, 64);
+    i.segmentCount = get<uint32_t>(entry, 72);
+    i.checksum = get<uint64_t>(entry, 80);
+    return i;
+}
+
+long TrackLibrary::find(std::string_view name) const {
+    // Indeks jest posortowany po nazwie - wyszukiwanie binarne
+    size_t lo = 0, hi = trackCount;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        std::string_view candidate = info(mid).name;
+        if (candidate == name) return static_cast<long>(mid);
+        if (candidate < name) lo = mid + 1;
+        else hi = mid;
+    }
+    return -1;
+}
+
+const Track* TrackLibrary::track(size_t index) {
+    if (index >= trackCount) return nullptr;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = compiled.find(index);
+    if (it != compiled.end()) return it->second.get();
+
+    TrackInfo i = info(index);
+    uint64_t offset = get<uint64_t>(data + HEADER_SIZE + index * ENTRY_SIZE, 88);
+    uint64_t bytes = static_cast<uint64_t>(i.segmentCount) * SEGMENT_SIZE;
+    if (i.name.empty() || i.segmentCount == 0) {
+        std::cerr << "Corrupted track library entry: " << index << std::endl;
+        return nullptr;
+    }
+    if (offset > dataSize || bytes > dataSize - offset || fnv1a(data + offset, bytes) != i.checksum) {
+        std::cerr << "Track checksum mismatch in library: " << i.name << std::endl;
+        return nullptr;
+    }
+
+    auto t = std::make_unique<Track>();
+    t->name = std::string(i.name);
+    t->filePath = path;
+    t->totalLength = i.totalLength;
+    t->segments.reserve(i.segmentCount);
+
+    for (uint32_t s = 0; s < i.segmentCount; ++s) {
+        const unsigned char* rec = data + offset + s * SEGMENT_SIZE;
+        TrackSegment seg;
+        seg.type = (get<uint32_t>(rec, 0) == SEGMENT_CORNER) ? "CORNER" : "STRAIGHT";
+        seg.length = get<double>(rec, 8);
+        seg.angle = get<double>(rec, 16);
+        seg.radius = get<double>(rec, 24);
+        t->segments.push_back(seg);
+    }
+
+    const Track* result = t.get();
+    compiled.emplace(index, std::move(t));
+    return result;
+}
@@ -0,0 +1,307 @@
+#include "../include/f1sim.h"
+#include "../include/ConfigParser.h"
+#include "../include/Race.h"
+#include "../include/Simulation.h"
+#include "../include/TrackLibrary.h"
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <random>
+
+struct f1sim_config {
+    std::vector<Driver> drivers;
+    std::vector<Team> teams;
+    int laps;
+};
+
+struct f1sim_track {
+    Track track;
+};
+
+struct f1sim_library {
+    TrackLibrary library;
+};
+
+struct f1sim_batch {
+    std::vector<Driver> drivers;
+    Track track;
+    int laps;
+    WeatherType weather;
+
+    // Przestrzeń robocza wielokrotnego użytku
+    double qualifyingBase;
+    std::vector<double> qualifyingMultipliers;
+    std::vector<double> qualifyingTimes;
+    std::vector<int> gridOrder;
+    std::vector<Car> templates;
+    std::vector<Car> grid;
+    std::unique_ptr<Race> race;
+};
+
+namespace {
+
+WeatherType toWeather(f1sim_weather weather) {
+    switch (weather) {
+        case F1SIM_WEATHER_CLOUDY: return WeatherType::Cloudy;
+        case F1SIM_WEATHER_RAINY: return WeatherType::Rainy;
+        case F1SIM_WEATHER_STORM: return WeatherType::Storm;
+        default: return WeatherType::Sunny;
+    }
+}
+
+void runOne(f1sim_batch& b, uint32_t seed) {
+    // Ta sama sekwencja losowań co simulateRace: szum kwalifikacji, potem ziarno wyścigu
+    std::mt19937 gen(seed);
+    std::normal_distribution<> noise(0, QUALIFYING_TIME_SIGMA);
+
+    size_t n = b.drivers.size();
+    for (size_t i = 0; i < n; ++i) {
+        b.qualifyingTimes[i] = b.qualifyingBase * b.qualifyingMultipliers[i] + noise(gen);
+        b.gridOrder[i] = i;
+    }
+    std::sort(b.gridOrder.begin(), b.gridOrder.end(), [&b](int x, int y) {
+        return b.qualifyingTimes[x] < b.qualifyingTimes[y];
+    });
+
+    for (size_t k = 0; k < n; ++k) {
+        b.grid[k] = b.templates[b.gridOrder[k]];
+        b.grid[k].placeOnGrid(k);
+    }
+
+    b.race->reset(b.grid, gen());
+    b.race->runToFinish();
+}
+
+void writeResults(const f1sim_batch& b, int raceIndex, const f1sim_results& out) {
+    size_t n = b.drivers.size();
+    const auto& cars = b.race->getCars();
+
+    for (size_t pos = 0; pos < cars.size(); ++pos) {
+        const Car& car = cars[pos];
+        int grid = car.getGridPosition();
+        size_t row = static_cast<size_t>(raceIndex) * n + b.gridOrder[grid];
+
+        if (out.positions) out.positions[row] = pos + 1;
+        if (out.grid_positions) out.grid_positions[row] = grid + 1;
+        if (out.finish_times) out.finish_times[row] = car.getFinishTime();
+
+        if (out.lap_times) {
+            double* laps = out.lap_times + row * b.laps;
+            const auto& lapTimes = car.getLapTimes();
+            for (int l = 0; l < b.laps; ++l) {
+                laps[l] = (l < static_cast<int>(lapTimes.size())) ? lapTimes[l] : 0.0;
+            }
+        }
+
+        const auto& pitLaps = car.getPitLaps();
+        if (out.pit_counts) out.pit_counts[row] = pitLaps.size();
+        if (out.pit_laps && out.max_pit_laps > 0) {
+            int32_t* pits = out.pit_laps + row * out.max_pit_laps;
+            for (int p = 0; p < out.max_pit_laps; ++p) {
+                pits[p] = (p < static_cast<int>(pitLaps.size())) ? pitLaps[p] : 0;
+            }
+        }
+    }
+}
+
+}
+
+extern "C" {
+
+int f1sim_api_version(void) {
+    return F1SIM_API_VERSION;
+}
+
+f1sim_status f1sim_config_load(const char* path, f1sim_config** out) {
+    if (!path || !out) return F1SIM_ERROR_ARGUMENT;
+    *out = nullptr;
+    try {
+        ConfigParser parser;
+        if (!parser.loadMainConfig(path)) return F1SIM_ERROR_IO;
+
+        auto config = std::make_unique<f1sim_config>();
+        config->drivers = parser.getDrivers();
+        config->teams = parser.getTeams();
+        config->laps = parser.getGlobalConfig().laps;
+        if (config->laps <= 0) config->laps = 10;
+        *out = config.release();
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+void f1sim_config_free(f1sim_config* config) {
+    delete config;
+}
+
+int f1sim_config_driver_count(const f1sim_config* config) {
+    return config ? static_cast<int>(config->drivers.size()) : 0;
+}
+
+const char* f1sim_config_driver_name(const f1sim_config* config, int index) {
+    if (!config || index < 0 || index >= static_cast<int>(config->drivers.size())) return nullptr;
+    return config->drivers[index].name.c_str();
+}
+
+const char* f1sim_config_driver_team(const f1sim_config* config, int index) {
+    if (!config || index < 0 || index >= static_cast<int>(config->drivers.size())) return nullptr;
+    return config->drivers[index].teamName.c_str();
+}
+
+int f1sim_config_laps(const f1sim_config* config) {
+    return config ? config->laps : 0;
+}
+
+f1sim_status f1sim_track_load(const char* path, f1sim_track** out) {
+    if (!path || !out) return F1SIM_ERROR_ARGUMENT;
+    *out = nullptr;
+    try {
+        if (!std::filesystem::exists(path)) return F1SIM_ERROR_IO;
+
+        ConfigParser parser;
+        auto track = std::make_unique<f1sim_track>();
+        track->track = parser.loadTrack(path);
+        if (track->track.segments.empty()) return F1SIM_ERROR_IO;
+        *out = track.release();
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+void f1sim_track_free(f1sim_track* track) {
+    delete track;
+}
+
+const char* f1sim_track_name(const f1sim_track* track) {
+    return track ? track->track.name.c_str() : nullptr;
+}
+
+double f1sim_track_length(const f1sim_track* track) {
+    return track ? track->track.totalLength : 0.0;
+}
+
+f1sim_status f1sim_library_open(const char* path, f1sim_library** out) {
+    if (!path || !out) return F1SIM_ERROR_ARGUMENT;
+    *out = nullptr;
+    try {
+        auto library = std::make_unique<f1sim_library>();
+        if (!library->library.open(path)) return F1SIM_ERROR_IO;
+        *out = library.release();
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+void f1sim_library_free(f1sim_library* library) {
+    delete library;
+}
+
+int f1sim_library_track_count(const f1sim_library* library) {
+    return library ? static_cast<int>(library->library.size()) : 0;
+}
+
+int f1sim_library_find(const f1sim_library* library, const char* name) {
+    if (!library || !name) return -1;
+    return static_cast<int>(library->library.find(name));
+}
+
+const char* f1sim_library_track_name(const f1sim_library* library, int index, size_t* length) {
+    if (!library || index < 0 || index >= static_cast<int>(library->library.size())) return nullptr;
+    std::string_view name = library->library.info(index).name;
+    if (name.empty()) return nullptr;
+    if (length) *length = name.size();
+    return name.data();
+}
+
+f1sim_status f1sim_library_load_track(f1sim_library* library, int index, f1sim_track** out) {
+    if (!library || !out || index < 0 || index >= static_cast<int>(library->library.size())) return F1SIM_ERROR_ARGUMENT;
+    *out = nullptr;
+    try {
+        const Track* track = library->library.track(index);
+        if (!track) return F1SIM_ERROR_IO;
+        auto handle = std::make_unique<f1sim_track>();
+        handle->track = *track;
+        *out = handle.release();
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+f1sim_status f1sim_batch_create(const f1sim_config* config, const f1sim_track* track,
+                                int laps, f1sim_weather weather, f1sim_batch** out) {
+    if (!config || !track || !out || config->drivers.empty() || track->track.segments.empty()) return F1SIM_ERROR_ARGUMENT;
+    *out = nullptr;
+    try {
+        auto b = std::make_unique<f1sim_batch>();
+        b->drivers = config->drivers;
+        b->track = track->track;
+        b->laps = (laps > 0) ? laps : config->laps;
+        b->weather = toWeather(weather);
+
+        size_t n = b->drivers.size();
+        b->qualifyingBase = qualifyingBaseLapTime(b->track);
+        b->qualifyingTimes.resize(n);
+        b->gridOrder.resize(n);
+
+        for (const auto& driver : b->drivers) {
+            Team team{};
+            for (const auto& t : config->teams) {
+                if (t.name == driver.teamName) team = t;
+            }
+            b->qualifyingMultipliers.push_back(qualifyingTimeMultiplier(driver, team));
+            b->templates.emplace_back(driver, team, 0);
+        }
+        b->grid = b->templates;
+        b->race = std::make_unique<Race>(b->grid, b->track, b->laps, b->weather, 0u);
+
+        // Rozgrzewka: rezerwuje pojemność wektorów okrążeń przed właściwymi wyścigami
+        runOne(*b, 0);
+
+        *out = b.release();
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+void f1sim_batch_free(f1sim_batch* batch) {
+    delete batch;
+}
+
+int f1sim_batch_laps(const f1sim_batch* batch) {
+    return batch ? batch->laps : 0;
+}
+
+int f1sim_batch_driver_count(const f1sim_batch* batch) {
+    return batch ? static_cast<int>(batch->drivers.size()) : 0;
+}
+
+f1sim_status f1sim_batch_set_step_threads(f1sim_batch* batch, int threads) {
+    if (!batch || threads < 1) return F1SIM_ERROR_ARGUMENT;
+    try {
+        batch->race->setThreadCount(threads);
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+f1sim_status f1sim_batch_run(f1sim_batch* batch, uint32_t first_seed, int race_count,
+                             const f1sim_results* out) {
+    if (!batch || !out || race_count < 0) return F1SIM_ERROR_ARGUMENT;
+    try {
+        for (int r = 0; r < race_count; ++r) {
+            runOne(*batch, first_seed + r);
+            writeResults(*batch, r, *out);
+        }
+        return F1SIM_OK;
+    } catch (...) {
+        return F1SIM_ERROR_INTERNAL;
+    }
+}
+
+}
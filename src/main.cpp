@@ -9,6 +9,8 @@
 #include "../include/ConfigParser.h"
 #include "../include/Race.h"
 #include "../include/Car.h"
+#include "../include/Simulation.h"
+#include "../include/TrackLibrary.h"
 
 namespace fs = std::filesystem;
 
@@ -26,84 +28,32 @@ void printHeader(const std::string& title) {
     std::cout << "========================================\n";
 }
 
-struct GridPosition {
-    int position;
-    Driver driver;
-    Team team;
-    double qualifyingTime;
-};
-
-std::vector<GridPosition> simulateQualifying(const std::vector<Driver>& drivers, const std::vector<Team>& teams, const Track& track) {
-    std::vector<GridPosition> grid;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<> d(0, 0.2);
-
-    std::map<std::string, Team> teamMap;
-    for (const auto& t : teams) teamMap[t.name] = t;
-
-    double baseLapTime = 0.0;
-    
-    for (const auto& seg : track.segments) {
-        double segmentSpeed = 0;
-        
-        if (seg.type == "STRAIGHT") {
-            if (seg.length > 500) segmentSpeed = 75.0;
-            else segmentSpeed = 55.0;
-        } else {
-            double absRadius = std::abs(seg.radius);
-            if (absRadius < 1.0) absRadius = 1.0;
-
-            double cornerGrip = 2.5;
-            double vMax = std::sqrt(absRadius * 9.81 * cornerGrip);
-            
-            if (vMax > 85.0) vMax = 85.0; 
-            segmentSpeed = vMax;
-        }
-        
-        if (segmentSpeed < 1.0) segmentSpeed = 1.0;
-        baseLapTime += (seg.length / segmentSpeed);
-    }
-    
-    baseLapTime *= 1.10; 
-
-    for (const auto& driver : drivers) {
-        Team car = teamMap[driver.teamName];
-        
-        double carScore = (car.topSpeed / 100.0) * 0.4 + (car.acceleration / 15.0) * 0.3 + (car.baseTireGrip / 2.5) * 0.3;
-        double driverScore = (driver.pace / 100.0) * 0.7 + (driver.racecraft / 100.0) * 0.3;
-        double totalPerformance = (carScore * 0.65 + driverScore * 0.35);
-        double timeMultiplier = 1.45 - (totalPerformance * 0.6); 
-
-        double simulatedTime = baseLapTime * timeMultiplier + d(gen);
-
-        GridPosition pos;
-        pos.driver = driver;
-        pos.team = car;
-        pos.qualifyingTime = simulatedTime;
-        grid.push_back(pos);
+Track selectTrackFromLibrary(TrackLibrary& library) {
+    printHeader("SELECT TRACK");
+    for (size_t i = 0; i < library.size(); ++i) {
+        TrackInfo info = library.info(i);
+        std::cout << "[" << i + 1 << "] " << info.name << " (" << (int)info.totalLength << "m)\n";
     }
 
-    std::sort(grid.begin(), grid.end(), [](const GridPosition& a, const GridPosition& b) {
-        return a.qualifyingTime < b.qualifyingTime;
-    });
+    int choice;
+    std::cout << "\nChoice: ";
+    std::cin >> choice;
 
-    for (size_t i = 0; i < grid.size(); ++i) {
-        grid[i].position = i + 1;
-    }
+    if (choice < 1 || static_cast<size_t>(choice) > library.size()) choice = 1;
 
-    return grid;
+    const Track* track = library.track(choice - 1);
+    return track ? *track : Track{};
 }
 
 Track selectTrack() {
     std::vector<std::string> trackFiles;
-    std::string configDir = "config";
+    std::string configDir = ConfigParser::locateConfigDir();
 
-    if (!fs::exists(configDir)) {
-        if (fs::exists("../config")) configDir = "../config";
-        else if (fs::exists("../../config")) configDir = "../../config";
+    TrackLibrary library;
+    if (fs::exists(configDir + "/tracks.f1lib") && library.open(configDir + "/tracks.f1lib") && library.size() > 0) {
+        return selectTrackFromLibrary(library);
     }
-    
+
     for (const auto& entry : fs::directory_iterator(configDir)) {
         if (entry.path().extension() == ".txt" && entry.path().filename() != "config.txt") {
             trackFiles.push_back(entry.path().string());
@@ -155,15 +105,7 @@ std::string formatTime(double seconds) {
 
 int main() {
     ConfigParser parser;
-    std::string configPath = "config/config.txt";
-    
-    if (!fs::exists(configPath)) {
-        if (fs::exists("../config/config.txt")) {
-            configPath = "../config/config.txt";
-        } else if (fs::exists("../../config/config.txt")) {
-            configPath = "../../config/config.txt";
-        }
-    }
+    std::string configPath = ConfigParser::locateConfigDir() + "/config.txt";
 
     if (!parser.loadMainConfig(configPath)) {
         std::cerr << "CRITICAL ERROR: Cannot open config file. Searching in: " << fs::current_path() << std::endl;
@@ -176,6 +118,10 @@ int main() {
     std::cout << "############################################\n";
 
     Track selectedTrack = selectTrack();
+    if (selectedTrack.segments.empty()) {
+        std::cerr << "CRITICAL ERROR: Selected track has no segments." << std::endl;
+        return 1;
+    }
     std::cout << "Selected Track: " << selectedTrack.name << " (" << (int)selectedTrack.totalLength << "m)\n";
 
     WeatherType weather = selectWeather();
@@ -185,7 +131,9 @@ int main() {
 
     std::cout << "\nGenerating Starting Grid based on Q3 Simulation...\n";
 
-    auto grid = simulateQualifying(drivers, teams, selectedTrack);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    auto grid = simulateQualifying(drivers, teams, selectedTrack, gen);
 
     clearConsole();
     printHeader("STARTING GRID - " + selectedTrack.name);
@@ -206,16 +154,12 @@ int main() {
     std::cin.ignore(); 
     std::cin.get();
 
-    std::vector<Car> raceCars;
-    for (size_t i = 0; i < grid.size(); ++i) {
-        Car car(grid[i].driver, grid[i].team, i);
-        raceCars.push_back(car);
-    }
+    std::vector<Car> raceCars = buildStartingGrid(grid);
 
     int laps = parser.getGlobalConfig().laps;
     if (laps <= 0) laps = 10;
 
-    Race race(raceCars, selectedTrack, laps);
+    Race race(raceCars, selectedTrack, laps, weather);
     race.run();
 
     return 0;
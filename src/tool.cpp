@@ -0,0 +1,495 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include "../include/ConfigParser.h"
+#include "../include/Simulation.h"
+#include "../include/LapModel.h"
+#include "../include/TrackLibrary.h"
+#include "../include/MonteCarlo.h"
+#include "../include/RaceStore.h"
+#include "../include/RaceScheduler.h"
+#include "../include/Sensitivity.h"
+#include "../include/ResultCache.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+void printUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  f1sim_tool calibrate <track> [races=20] [weather=Sunny]\n";
+    std::cout << "      Calibrates the lap model from full physics runs and prints an accuracy report.\n";
+    std::cout << "  f1sim_tool pack-tracks <library.f1lib> <track.txt|directory>...\n";
+    std::cout << "      Builds an indexed track library from text track files.\n";
+    std::cout << "  f1sim_tool list-tracks <library.f1lib>\n";
+    std::cout << "      Lists tracks stored in a library.\n";
+    std::cout << "  f1sim_tool montecarlo <track> [key=value]...\n";
+    std::cout << "      Adaptive Monte Carlo until every metric reaches its precision or the time budget ends.\n";
+    std::cout << "      Keys: win=0.01 podium=0.01 position=0.1 (target half-widths, 0 = skip metric),\n";
+    std::cout << "            confidence=0.95 budget=<seconds> batch=200 threads=<n> max=<races>\n";
+    std::cout << "            seed=1 weather=Sunny fidelity=full|lap cache=<dir> cachesize=<MB>\n";
+    std::cout << "  f1sim_tool store <track> <output.f1races> [races=1000] [seed=1] [weather=Sunny] [fidelity=full|lap]\n";
+    std::cout << "                   [cache=<dir>] [cachesize=1024]\n";
+    std::cout << "      Simulates races and writes compact per-race summaries to a columnar store.\n";
+    std::cout << "      With cache=<dir>, full-physics results are reused per seed from an on-disk cache\n";
+    std::cout << "      keyed by the resolved scenario (least recently used entries evicted above cachesize).\n";
+    std::cout << "  f1sim_tool query <store.f1races> winner=<driver> [fromgrid=1]\n";
+    std::cout << "      Lists races won by a driver who started from the given grid slot or further back.\n";
+    std::cout << "  f1sim_tool sensitivity <track> [key=value]...\n";
+    std::cout << "      Finite-difference sensitivity of finishing position to team and driver parameters,\n";
+    std::cout << "      using paired races with common random numbers.\n";
+    std::cout << "      Keys: params=topSpeed,acceleration,braking,baseTireGrip,pace target=<team|driver>\n";
+    std::cout << "            step=0.02 (fraction of value) precision=0.05 (positions per step) confidence=0.95\n";
+    std::cout << "            budget=<seconds> batch=20 threads=<n> max=<races> seed=1 weather=Sunny\n";
+    std::cout << "  f1sim_tool live <track> [races=1000] [workers=4] [speed=0] [seed=1] [weather=Sunny]\n";
+    std::cout << "      Runs many live races interleaved on a few worker threads (speed = simulated seconds\n";
+    std::cout << "      per real second for each race, 0 = as fast as possible) and prints progress.\n";
+}
+
+bool loadSetup(const std::string& trackArg, WeatherType weather, RaceSetup& setup) {
+    std::string configDir = ConfigParser::locateConfigDir();
+    ConfigParser parser;
+    if (!parser.loadMainConfig(configDir + "/config.txt")) return false;
+
+    std::string trackPath = trackArg;
+    if (!fs::exists(trackPath)) trackPath = configDir + "/" + trackArg + ".txt";
+
+    if (fs::exists(trackPath)) {
+        setup.track = parser.loadTrack(trackPath);
+    } else {
+        // Tor spoza plików tekstowych - szukaj w bibliotece torów
+        TrackLibrary library;
+        long index = -1;
+        if (fs::exists(configDir + "/tracks.f1lib") && library.open(configDir + "/tracks.f1lib")) {
+            index = library.find(trackArg);
+        }
+        const Track* track = (index >= 0) ? library.track(index) : nullptr;
+        if (!track) {
+            std::cerr << "Track not found: " << trackArg << std::endl;
+            return false;
+        }
+        setup.track = *track;
+    }
+
+    setup.drivers = parser.getDrivers();
+    setup.teams = parser.getTeams();
+    setup.laps = parser.getGlobalConfig().laps;
+    if (setup.laps <= 0) setup.laps = 10;
+    setup.weather = weather;
+    return !setup.track.segments.empty();
+}
+
+int runCalibrate(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    int races = (argc > 3) ? std::stoi(argv[3]) : 20;
+    WeatherType weather = (argc > 4) ? ConfigParser::parseWeather(argv[4]) : WeatherType::Sunny;
+
+    RaceSetup setup;
+    if (!loadSetup(argv[2], weather, setup)) return 1;
+
+    std::cout << "Calibrating lap model for " << setup.track.name << " (" << ConfigParser::weatherName(weather)
+              << ", " << setup.laps << " laps) from " << races << " full physics races...\n";
+
+    LapModel model = LapModel::calibrate(setup, races, 1);
+
+    std::string modelPath = ConfigParser::locateConfigDir() + "/" + setup.track.name + "_"
+                          + ConfigParser::weatherName(weather) + ".lapmodel";
+    if (!model.save(modelPath)) return 1;
+    std::cout << "Saved: " << modelPath << "\n\n";
+
+    // Raport na ziarnach rozłącznych z kalibracją
+    LapModelAccuracy report = LapModel::evaluate(model, setup, races, 1000000);
+
+    std::cout << std::left << std::setw(18) << "DRIVER"
+              << std::setw(12) << "POS FULL" << std::setw(12) << "POS MODEL"
+              << std::setw(14) << "TIME FULL" << "TIME MODEL" << "\n";
+    std::cout << "-----------------------------------------------------------------------\n";
+    for (const auto& row : report.drivers) {
+        std::cout << std::left << std::setw(18) << row.driverName << std::fixed << std::setprecision(2)
+                  << std::setw(12) << row.fullMeanPosition << std::setw(12) << row.modelMeanPosition
+                  << std::setprecision(1) << std::setw(14) << row.fullMeanTime << row.modelMeanTime << "\n";
+    }
+
+    std::cout << "\nMean |position error|: " << std::setprecision(3) << report.meanAbsPositionError << "\n";
+    std::cout << "Mean relative time error: " << std::setprecision(3) << report.meanRelTimeError * 100.0 << "%\n";
+    std::cout << "Rank correlation: " << std::setprecision(3) << report.rankCorrelation << "\n";
+    std::cout << "Full physics: " << report.fullSeconds << "s | Lap model: " << report.modelSeconds << "s";
+    if (report.modelSeconds > 0) {
+        std::cout << " | Speedup: " << std::setprecision(0) << report.fullSeconds / report.modelSeconds << "x";
+    }
+    std::cout << "\n";
+    return 0;
+}
+
+int runPackTracks(int argc, char** argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    for (int i = 3; i < argc; ++i) {
+        if (fs::is_directory(argv[i])) {
+            for (const auto& entry : fs::directory_iterator(argv[i])) {
+                if (entry.path().extension() == ".txt" && entry.path().filename() != "config.txt") {
+                    files.push_back(entry.path().string());
+                }
+            }
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    ConfigParser parser;
+    std::vector<Track> tracks;
+    for (const auto& file : files) {
+        Track t = parser.loadTrack(file);
+        if (t.segments.empty()) {
+            std::cerr << "Skipping empty track: " << file << std::endl;
+            continue;
+        }
+        tracks.push_back(t);
+    }
+
+    if (!TrackLibrary::build(tracks, argv[2])) return 1;
+    std::cout << "Packed " << tracks.size() << " tracks into " << argv[2] << "\n";
+    return 0;
+}
+
+int runListTracks(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    TrackLibrary library;
+    if (!library.open(argv[2])) return 1;
+
+    std::cout << std::left << std::setw(32) << "TRACK" << std::setw(12) << "LENGTH" << std::setw(10) << "SEGMENTS" << "CHECKSUM\n";
+    for (size_t i = 0; i < library.size(); ++i) {
+        TrackInfo info = library.info(i);
+        std::cout << std::left << std::setw(32) << info.name << std::setw(12) << (int)info.totalLength
+                  << std::setw(10) << info.segmentCount << std::hex << info.checksum << std::dec << "\n";
+    }
+    return 0;
+}
+
+std::map<std::string, std::string> parseOptions(int argc, char** argv, int first) {
+    std::map<std::string, std::string> options;
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) options[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+    return options;
+}
+
+std::string option(const std::map<std::string, std::string>& options, const std::string& key, const std::string& fallback) {
+    auto it = options.find(key);
+    return (it != options.end()) ? it->second : fallback;
+}
+
+// Pamięć podręczna wyników z opcji cache=<katalog> cachesize=<MB>; nullptr, gdy wyłączona
+std::unique_ptr<ResultCache> openCache(const std::map<std::string, std::string>& opts) {
+    std::string dir = option(opts, "cache", "");
+    if (dir.empty()) return nullptr;
+    auto cache = std::make_unique<ResultCache>(dir, std::stoull(option(opts, "cachesize", "1024")) << 20);
+    if (!cache->open()) return nullptr;
+    return cache;
+}
+
+void printCacheStats(const ResultCache* cache) {
+    if (!cache) return;
+    const CacheStats& stats = cache->getStats();
+    std::cout << "Cache: " << stats.hits << " hits, " << stats.misses << " computed, " << stats.evicted
+              << " evicted, " << cache->sizeBytes() / 1024 << " KiB on disk\n";
+}
+
+int runMonteCarlo(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    auto opts = parseOptions(argc, argv, 3);
+    WeatherType weather = ConfigParser::parseWeather(option(opts, "weather", "Sunny"));
+
+    RaceSetup setup;
+    if (!loadSetup(argv[2], weather, setup)) return 1;
+
+    MonteCarloOptions mc;
+    double win = std::stod(option(opts, "win", "0.01"));
+    double podium = std::stod(option(opts, "podium", "0.01"));
+    double position = std::stod(option(opts, "position", "0.1"));
+    if (win > 0) mc.targets.push_back({MonteCarloMetric::WinProbability, win});
+    if (podium > 0) mc.targets.push_back({MonteCarloMetric::PodiumProbability, podium});
+    if (position > 0) mc.targets.push_back({MonteCarloMetric::MeanPosition, position});
+    if (mc.targets.empty()) {
+        std::cerr << "All metrics skipped (win, podium and position are 0) - nothing to estimate." << std::endl;
+        return 1;
+    }
+    mc.confidence = std::stod(option(opts, "confidence", "0.95"));
+    mc.timeBudgetSeconds = std::stod(option(opts, "budget", "0"));
+    mc.batchSize = std::stoi(option(opts, "batch", "200"));
+    mc.threads = std::stoi(option(opts, "threads", "0"));
+    mc.maxRaces = std::stoi(option(opts, "max", "1000000"));
+    mc.firstSeed = std::stoul(option(opts, "seed", "1"));
+
+    LapModel lapModel;
+    if (option(opts, "fidelity", "full") == "lap") {
+        std::string modelPath = ConfigParser::locateConfigDir() + "/" + setup.track.name + "_"
+                              + ConfigParser::weatherName(weather) + ".lapmodel";
+        if (!lapModel.load(modelPath)) {
+            std::cerr << "Run 'f1sim_tool calibrate " << setup.track.name << "' first." << std::endl;
+            return 1;
+        }
+        if (!lapModel.compatible(setup)) return 1;
+        mc.fidelity = SimFidelity::LapModel;
+        mc.lapModel = &lapModel;
+    }
+
+    auto cache = openCache(opts);
+    mc.cache = cache.get();
+
+    AdaptiveSampler sampler(setup, mc);
+    MonteCarloReport report = sampler.run();
+
+    std::cout << std::left << std::setw(18) << "DRIVER" << std::setw(20) << "WIN %"
+              << std::setw(20) << "PODIUM %" << "MEAN POS" << "\n";
+    std::cout << "-----------------------------------------------------------------------\n";
+    for (const auto& d : report.drivers) {
+        std::stringstream winStr, podiumStr, posStr;
+        winStr << std::fixed << std::setprecision(2) << d.win.value * 100.0 << " +/- " << d.win.halfWidth * 100.0;
+        podiumStr << std::fixed << std::setprecision(2) << d.podium.value * 100.0 << " +/- " << d.podium.halfWidth * 100.0;
+        posStr << std::fixed << std::setprecision(2) << d.meanPosition.value << " +/- " << d.meanPosition.halfWidth;
+        std::cout << std::left << std::setw(18) << d.driverName << std::setw(20) << winStr.str()
+                  << std::setw(20) << podiumStr.str() << posStr.str() << "\n";
+    }
+
+    std::cout << "\nRaces: " << report.races << " in " << std::fixed << std::setprecision(1) << report.seconds << "s | "
+              << (report.converged ? "Converged" : "Stopped before target precision")
+              << " (worst interval / target = " << std::setprecision(2) << report.worstRatio << ")\n";
+    printCacheStats(cache.get());
+    return 0;
+}
+
+int runStore(int argc, char** argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    auto opts = parseOptions(argc, argv, 4);
+    WeatherType weather = ConfigParser::parseWeather(option(opts, "weather", "Sunny"));
+    RaceSetup setup;
+    if (!loadSetup(argv[2], weather, setup)) return 1;
+
+    int races = std::stoi(option(opts, "races", "1000"));
+    unsigned int firstSeed = std::stoul(option(opts, "seed", "1"));
+
+    LapModel lapModel;
+    bool fast = option(opts, "fidelity", "full") == "lap";
+    if (fast && (!lapModel.load(ConfigParser::locateConfigDir() + "/" + setup.track.name + "_"
+                                + ConfigParser::weatherName(weather) + ".lapmodel") || !lapModel.compatible(setup))) {
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    for (const auto& d : setup.drivers) names.push_back(d.name);
+
+    auto cache = fast ? nullptr : openCache(opts);
+
+    RaceStoreWriter writer;
+    if (!writer.open(argv[3], names, setup.laps)) return 1;
+    if (cache) {
+        // Paczkami, żeby nie trzymać wszystkich wyników w pamięci
+        int threads = std::max(1u, std::thread::hardware_concurrency());
+        for (int r = 0; r < races; r += 1000) {
+            for (const auto& result : cache->run(setup, firstSeed + r, std::min(1000, races - r), threads)) {
+                if (!writer.append(result)) return 1;
+            }
+        }
+    } else {
+        for (int r = 0; r < races; ++r) {
+            RaceResult result = fast ? lapModel.simulate(setup, firstSeed + r) : simulateRace(setup, firstSeed + r);
+            if (!writer.append(result)) return 1;
+        }
+    }
+    if (!writer.close()) return 1;
+
+    auto bytes = fs::file_size(argv[3]);
+    std::cout << "Stored " << races << " races in " << argv[3] << " (" << bytes << " bytes, "
+              << std::fixed << std::setprecision(1) << (races > 0 ? (double)bytes / races : 0.0) << " bytes/race)\n";
+    printCacheStats(cache.get());
+    return 0;
+}
+
+int runQuery(int argc, char** argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    auto opts = parseOptions(argc, argv, 3);
+    RaceStoreReader reader;
+    if (!reader.open(argv[2])) return 1;
+
+    std::string winner = option(opts, "winner", "");
+    if (reader.driverIndex(winner) < 0) {
+        std::cerr << "Unknown driver: " << winner << std::endl;
+        return 1;
+    }
+
+    int fromGrid = std::stoi(option(opts, "fromgrid", "1"));
+    auto seeds = reader.findWins(winner, fromGrid);
+
+    std::cout << winner << " won " << seeds.size() << " of " << reader.raceCount()
+              << " races starting from P" << fromGrid << " or lower\n";
+    for (size_t i = 0; i < seeds.size() && i < 20; ++i) std::cout << "  seed " << seeds[i] << "\n";
+    if (seeds.size() > 20) std::cout << "  ...\n";
+    return 0;
+}
+
+int runSensitivity(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    auto opts = parseOptions(argc, argv, 3);
+    WeatherType weather = ConfigParser::parseWeather(option(opts, "weather", "Sunny"));
+    RaceSetup setup;
+    if (!loadSetup(argv[2], weather, setup)) return 1;
+
+    std::vector<SensitivityParameter> parameters;
+    std::stringstream list(option(opts, "params", "topSpeed,acceleration,braking,baseTireGrip,pace"));
+    std::string name;
+    while (std::getline(list, name, ',')) {
+        SensitivityParameter parameter;
+        if (!parseSensitivityParameter(name, parameter)) {
+            std::cerr << "Unknown parameter: " << name << std::endl;
+            return 1;
+        }
+        parameters.push_back(parameter);
+    }
+
+    SensitivityOptions so;
+    so.perturbations = buildPerturbations(setup, parameters, std::stod(option(opts, "step", "0.02")), option(opts, "target", ""));
+    if (so.perturbations.empty()) {
+        std::cerr << "Nothing to perturb for target: " << option(opts, "target", "") << std::endl;
+        return 1;
+    }
+    so.precision = std::stod(option(opts, "precision", "0.05"));
+    so.confidence = std::stod(option(opts, "confidence", "0.95"));
+    so.timeBudgetSeconds = std::stod(option(opts, "budget", "0"));
+    so.batchSize = std::stoi(option(opts, "batch", "20"));
+    so.threads = std::stoi(option(opts, "threads", "0"));
+    so.maxRaces = std::stoi(option(opts, "max", "100000"));
+    so.firstSeed = std::stoul(option(opts, "seed", "1"));
+
+    SensitivityAnalyzer analyzer(setup, so);
+    SensitivityReport report = analyzer.run();
+
+    std::cout << std::left << std::setw(14) << "PARAMETER" << std::setw(16) << "TARGET" << std::setw(14) << "DRIVER"
+              << std::setw(10) << "STEP" << std::setw(10) << "BASE POS" << std::setw(26) << "POS PER STEP" << "VAR REDUCTION" << "\n";
+    std::cout << "------------------------------------------------------------------------------------------------------\n";
+    for (const auto& e : report.estimates) {
+        std::stringstream step, effect, reduction;
+        step << std::setprecision(3) << e.perturbation.step;
+        effect << std::fixed << std::setprecision(3) << e.slope.value * e.perturbation.step
+               << " +/- " << e.slope.halfWidth * e.perturbation.step;
+        if (e.varianceReduction > 0) reduction << std::fixed << std::setprecision(1) << e.varianceReduction << "x";
+        else reduction << "-";
+        std::cout << std::left << std::setw(14) << sensitivityParameterName(e.perturbation.parameter)
+                  << std::setw(16) << e.perturbation.target << std::setw(14) << e.driverName
+                  << std::setw(10) << step.str() << std::setw(10) << std::fixed << std::setprecision(2) << e.baselinePosition
+                  << std::setw(26) << effect.str() << reduction.str() << "\n";
+    }
+
+    std::cout << "\nSeeds: " << report.races << " (" << report.simulations << " races) in " << std::fixed
+              << std::setprecision(1) << report.seconds << "s | "
+              << (report.converged ? "Converged" : "Stopped before target precision") << "\n";
+    std::cout << "Negative values mean the driver finishes further ahead when the parameter grows.\n";
+    return 0;
+}
+
+int runLive(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    auto opts = parseOptions(argc, argv, 3);
+    WeatherType weather = ConfigParser::parseWeather(option(opts, "weather", "Sunny"));
+    RaceSetup setup;
+    if (!loadSetup(argv[2], weather, setup)) return 1;
+
+    int races = std::stoi(option(opts, "races", "1000"));
+    int workers = std::stoi(option(opts, "workers", "4"));
+    double speed = std::stod(option(opts, "speed", "0"));
+    unsigned int firstSeed = std::stoul(option(opts, "seed", "1"));
+
+    std::mutex tallyMutex;
+    std::map<std::string, int> wins;
+    auto onFrame = [&](int, const Race& race) {
+        if (!race.isFinished()) return;
+        RaceResult result = race.getResult();
+        if (result.classification.empty()) return;
+        std::lock_guard<std::mutex> lock(tallyMutex);
+        wins[result.classification[0].driverName]++;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    RaceScheduler scheduler(workers);
+    for (int r = 0; r < races; ++r) {
+        std::mt19937 gen(firstSeed + r);
+        auto grid = simulateQualifying(setup.drivers, setup.teams, setup.track, gen);
+        auto race = std::make_unique<Race>(buildStartingGrid(grid), setup.track, setup.laps, setup.weather, gen());
+        scheduler.add(std::move(race), speed, onFrame);
+    }
+
+    while (scheduler.runningCount() > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(1) << "[" << elapsed << "s] running: "
+                  << scheduler.runningCount() << " | finished: " << scheduler.finishedCount() << "\n";
+    }
+    scheduler.waitAll();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\nFinished " << scheduler.finishedCount() << " races on " << workers << " workers in "
+              << std::fixed << std::setprecision(1) << elapsed << "s\n";
+    for (const auto& [name, count] : wins) {
+        std::cout << "  " << std::left << std::setw(18) << name << count << " wins\n";
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "calibrate") return runCalibrate(argc, argv);
+    if (command == "pack-tracks") return runPackTracks(argc, argv);
+    if (command == "list-tracks") return runListTracks(argc, argv);
+    if (command == "montecarlo") return runMonteCarlo(argc, argv);
+    if (command == "store") return runStore(argc, argv);
+    if (command == "query") return runQuery(argc, argv);
+    if (command == "sensitivity") return runSensitivity(argc, argv);
+    if (command == "live") return runLive(argc, argv);
+
+    printUsage();
+    return 1;
+}